@@ -11,7 +11,8 @@ nooverwrite of existing data, existing directories are renamed.
 directories are named *.temp until complete.
 
 demand driven reads.
-headers contain min/max and seek for each grid (VisMF Header Versions 1 and 3).
+headers contain min/max and seek for each grid (VisMF Header Versions 1, 3 and 5).
+Header Version 5 compresses each component of each grid losslessly.
 data is addressable to a single component of a single grid.
 no restriction on the relationship between nprocs and nfiles for reading.
 stream throttling for reading to prevent thrashing.
@@ -27,17 +28,27 @@ vismf.usesinglewrite          (def:  false)
 vismf.checkfilepositions      (def:  false)
 vismf.usepersistentifstreams  (def:  true)
 vismf.usesynchronousreads     (def:  false)
+vismf.usedirectreads          (def:  false, each rank reads its own FABs, any BoxArray)
 vismf.usedynamicsetselection  (def:  true)
 vismf.iobuffersize            (def:  VisMF::IO_Buffer_Size)
+vismf.usemmap                 (def:  true, VisMF::GetFab maps the data files)
+vismf.binaryheader            (def:  false, write FabArray headers in the binary format)
+vismf.aggregatewrites         (def:  false, one writer per node and file, same files;
+                                      untested at scale and slower on one node)
+vismf.aggregatorranks         (def:  0, ranks per aggregator, 0 for all ranks of a node)
 amr.plot_nfiles               (def:  64)
 amr.checkpoint_nfiles         (def:  64)
 amr.mffile_nstreams           (def:  1)
 amr.plot_headerversion        (def:  Version_v1  (1) )
 amr.checkpoint_headerversion  (def:  Version_v1  (1) )
 amr.prereadFAHeaders          (def:  true)
+amr.checkpoint_async          (def:  false, write checkpoint data in the background)
+plotfile.lossy_tolerance      (def:  0, exact; plotfile.lossy_tolerance.<var> per variable)
+plotfile.pyramid_levels       (def:  0, number of coarsened copies of each level)
 amr.precreateDirectories      (def:  true)
 
 particles.particles_nfiles = 1024
+particles.columnar          (def:  false, one array per component and grid, see ParticleFileData)
 
 you can also call these to set fabconv buffer sizes:
 RealDescriptor::SetReadBufferSize(rbs);
@@ -32,6 +32,7 @@
 #include <AMReX_Utility.H>
 #include <AMReX_DistributionMapping.H>
 #include <AMReX_FabSet.H>
+#include <AMReX_FabFactory.H>
 #include <AMReX_StateData.H>
 #include <AMReX_PlotFileUtil.H>
 #include <AMReX_Print.H>
@@ -116,6 +117,7 @@ namespace
     int  insitu_on_restart;
     int  checkpoint_on_restart;
     bool checkpoint_files_output;
+    bool checkpoint_async;
     int  compute_new_dt_on_regrid;
     bool precreateDirectories;
     bool prereadFAHeaders;
@@ -151,6 +153,7 @@ Amr::Initialize ()
     insitu_on_restart        = 0;
     checkpoint_on_restart    = 0;
     checkpoint_files_output  = true;
+    checkpoint_async         = false;
     compute_new_dt_on_regrid = 0;
     precreateDirectories     = true;
     prereadFAHeaders         = true;
@@ -517,6 +520,17 @@ Amr::InitAmr ()
 
     loadbalance_max_fac = 1.5;
     pp.query("loadbalance_max_fac", loadbalance_max_fac);
+
+    compress_old_data = false;
+    pp.query("compress_old_data", compress_old_data);
+#ifdef AMREX_USE_GPU
+    if (compress_old_data) {
+        amrex::Abort("amr.compress_old_data: the state data are not host accessible in GPU builds");
+    }
+#endif
+
+    compress_old_data_tol = 0.0;
+    pp.query("compress_old_data_tol", compress_old_data_tol);
 }
 
 int
@@ -758,6 +772,8 @@ Amr::deleteDeriveSmallPlotVar (const std::string& name)
 
 Amr::~Amr ()
 {
+    finishAsyncCheckPoint();
+
     levelbld->variableCleanUp();
 
     Amr::Finalize();
@@ -1764,6 +1780,11 @@ Amr::checkPoint ()
     BL_PROFILE_REGION_START("Amr::checkPoint()");
     BL_PROFILE("Amr::checkPoint()");
 
+    //
+    // The previous checkpoint may still be written in the background.
+    //
+    finishAsyncCheckPoint();
+
     VisMF::SetNOutFiles(checkpoint_nfiles);
     //
     // In checkpoint files always write out FABs in NATIVE format.
@@ -1914,6 +1935,28 @@ Amr::checkPoint ()
 
 	amrex::Print() << "checkPoint() time = " << dCheckPointTime << " secs." << '\n';
     }
+    if (checkpoint_async)
+    {
+        int nerrors = StreamRetry::NStreamErrors();
+        ParallelDescriptor::ReduceIntSum(nerrors);
+        if (nerrors == 0) {
+            //
+            // The data are still being written, finishAsyncCheckPoint
+            // checks them and renames the checkpoint.
+            //
+            async_checkpoint_file = ckfile;
+            break;
+        }
+        //
+        // This try failed already and is retried below, once its
+        // background writes are done.
+        //
+        for (auto& f : async_checkpoint_writes) {
+            f.get();
+        }
+        async_checkpoint_writes.clear();
+    }
+
     ParallelDescriptor::Barrier("Amr::checkPoint::end");
 
     if(ParallelDescriptor::IOProcessor()) {
@@ -1933,6 +1976,64 @@ Amr::checkPoint ()
   BL_PROFILE_REGION_STOP("Amr::checkPoint()");
 }
 
+void
+Amr::finishAsyncCheckPoint ()
+{
+    if (async_checkpoint_writes.empty() && async_checkpoint_file.empty()) {
+        return;
+    }
+
+    BL_PROFILE("Amr::finishAsyncCheckPoint()");
+
+    Real dWaitTime0 = amrex::second();
+
+    int nfailed = 0;
+    for (auto& f : async_checkpoint_writes) {
+        const WriteAsyncStatus status = f.get();
+        if ( ! status.ok) {
+            ++nfailed;
+        }
+    }
+    async_checkpoint_writes.clear();
+
+    //
+    // The data were only staged in memory, so a failed write cannot be retried.
+    //
+    ParallelDescriptor::ReduceIntSum(nfailed);
+    if (nfailed > 0) {
+        amrex::Abort("Amr::finishAsyncCheckPoint: " + std::to_string(nfailed)
+                     + " background writes of " + async_checkpoint_file
+                     + " failed, it is left incomplete as "
+                     + async_checkpoint_file + ".temp");
+    }
+
+    if ( ! async_checkpoint_file.empty())
+    {
+        if(ParallelDescriptor::IOProcessor()) {
+            const std::string ckfileTemp(async_checkpoint_file + ".temp");
+            std::rename(ckfileTemp.c_str(), async_checkpoint_file.c_str());
+        }
+        ParallelDescriptor::Barrier("Renaming temporary checkPoint file.");
+        async_checkpoint_file.clear();
+    }
+
+    if (verbose > 0)
+    {
+        Real dWaitTime = amrex::second() - dWaitTime0;
+
+        ParallelDescriptor::ReduceRealMax(dWaitTime,
+                                    ParallelDescriptor::IOProcessorNumber());
+
+        amrex::Print() << "finishAsyncCheckPoint() wait time = " << dWaitTime << " secs." << '\n';
+    }
+}
+
+Vector<std::future<WriteAsyncStatus> >*
+Amr::asyncCheckPointWrites () noexcept
+{
+    return checkpoint_async ? &async_checkpoint_writes : nullptr;
+}
+
 void
 Amr::RegridOnly (Real time, bool do_io)
 {
@@ -2158,6 +2259,15 @@ Amr::timeStep (int  level,
     perilla::syncAllWorkerThreads();
 #endif
 
+    //
+    // From here on the old data of this level are normally only read to
+    // fill the finer levels, so they can be kept compressed.
+    //
+    if (compress_old_data)
+    {
+        amr_level[level]->compressOldData(compress_old_data_tol);
+    }
+
     //
     // Advance grids at higher level.
     //
@@ -2225,6 +2335,11 @@ Amr::coarseTimeStep (Real stop_time)
 
     run_strt = amrex::second() ;
 
+    //
+    // FAB buffers freed by the previous regrid age by one step.
+    //
+    FabRecycler::NextStep();
+
     //
     // Compute new dt.
     //
@@ -2473,6 +2588,11 @@ Amr::coarseTimeStep (Real stop_time)
 	});
 #endif
 #endif
+
+        if (compress_old_data)
+        {
+            printOldDataCompressionStats();
+        }
     }
 
 #ifdef AMREX_MEM_PROFILING
@@ -3154,6 +3274,35 @@ Amr::regrid_level_0_on_restart()
     }
 }
 
+void
+Amr::printOldDataCompressionStats () const
+{
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        long counts[3] = { 0L, 0L, 0L };
+        Real times[2] = { 0.0, 0.0 };
+        for (int i = 0; i < amr_level[lev]->numStates(); ++i)
+        {
+            const StateData::CompressionStats& cs = amr_level[lev]->get_state_data(i).compressionStats();
+            counts[0] += cs.raw_bytes;
+            counts[1] += cs.packed_bytes;
+            counts[2] += cs.ndecodes;
+            times[0] += cs.encode_time;
+            times[1] += cs.decode_time;
+        }
+        ParallelDescriptor::ReduceLongSum(counts, 3, IOProc);
+        ParallelDescriptor::ReduceRealMax(times, 2, IOProc);
+
+        const Real ratio = (counts[1] > 0) ? Real(counts[0])/Real(counts[1]) : 0.0;
+        amrex::Print() << "[Level " << lev << "] old data compression: "
+                       << counts[0]/(1024*1024) << " MB -> " << counts[1]/(1024*1024)
+                       << " MB (ratio " << ratio << "), max encode time " << times[0]
+                       << " s, " << counts[2] << " decodes, max decode time " << times[1] << " s\n";
+    }
+}
+
 void
 Amr::printGridInfo (std::ostream& os,
                     int           min_lev,
@@ -3494,6 +3643,7 @@ Amr::initPltAndChk ()
 
     pp.query("plot_nfiles", plot_nfiles);
     pp.query("checkpoint_nfiles", checkpoint_nfiles);
+    pp.query("checkpoint_async", checkpoint_async);
     //
     // -1 ==> use ParallelDescriptor::NProcs().
     //
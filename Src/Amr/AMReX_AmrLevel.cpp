@@ -507,7 +507,8 @@ AmrLevel::checkPoint (const std::string& dir,
         std::string PathNameInHdr = amrex::Concatenate(LevelDir + "/SD_", i, 1);
         std::string FullPathName  = amrex::Concatenate(FullPath + "/SD_", i, 1);
 
-        state[i].checkPoint(PathNameInHdr, FullPathName, os, how, dump_old);
+        state[i].checkPoint(PathNameInHdr, FullPathName, os, how, dump_old,
+                            parent->asyncCheckPointWrites());
     }
 
     levelDirectoryCreated = false;  // ---- now that the checkpoint is finished
@@ -553,6 +554,15 @@ AmrLevel::removeOldData ()
     }
 }
 
+void
+AmrLevel::compressOldData (Real tolerance)
+{
+    for (int i = 0; i < desc_lst.size(); i++)
+    {
+        state[i].compressOldData(tolerance);
+    }
+}
+
 void
 AmrLevel::reset ()
 {
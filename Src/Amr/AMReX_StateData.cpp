@@ -9,6 +9,7 @@
 #include <AMReX_StateDescriptor.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_Utility.H>
+#include <AMReX_FabCompress.H>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -54,7 +55,9 @@ StateData::StateData (StateData&& rhs) noexcept
       new_time(rhs.new_time),
       old_time(rhs.old_time),
       new_data(std::move(rhs.new_data)),
-      old_data(std::move(rhs.old_data))
+      old_data(std::move(rhs.old_data)),
+      m_old_packed(std::move(rhs.m_old_packed)),
+      m_cstats(rhs.m_cstats)
 {   
 }
 
@@ -70,14 +73,15 @@ StateData::operator= (StateData const& rhs)
     new_time = rhs.new_time;
     old_time = rhs.old_time;
     new_data.reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(),
-                                MFInfo().SetTag("StateData").SetArena(arena),
+                                MFInfo().SetTag("StateData").SetArena(arena).SetRecycle(true),
                                 *m_factory));
     MultiFab::Copy(*new_data, *rhs.new_data, 0, 0, desc->nComp(),desc->nExtra());
-    if (rhs.old_data) {
+    m_old_packed.reset();
+    if (rhs.hasOldData()) {
         old_data.reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(),
-                                    MFInfo().SetTag("StateData").SetArena(arena),
+                                    MFInfo().SetTag("StateData").SetArena(arena).SetRecycle(true),
                                     *m_factory));
-        MultiFab::Copy(*old_data, *rhs.old_data, 0, 0, desc->nComp(),desc->nExtra());
+        MultiFab::Copy(*old_data, rhs.oldData(), 0, 0, desc->nComp(),desc->nExtra());
     } else {
         old_data.reset();
     }
@@ -124,9 +128,10 @@ StateData::define (const Box&             p_domain,
     int ncomp = desc->nComp();
 
     new_data.reset(new MultiFab(grids,dmap,ncomp,desc->nExtra(),
-                                MFInfo().SetTag("StateData").SetArena(arena),
+                                MFInfo().SetTag("StateData").SetArena(arena).SetRecycle(true),
                                 *m_factory));
     old_data.reset();
+    m_old_packed.reset();
 }
 
 void
@@ -166,6 +171,8 @@ StateData::reset ()
 {
     new_time = old_time;
     old_time.start = old_time.stop = INVALID_TIME;
+    // The old data become the new data, so they have to be decoded.
+    uncompressOldData(true);
     std::swap(old_data, new_data);
 }
 
@@ -218,12 +225,13 @@ StateData::restartDoit (std::istream& is, const std::string& chkfile)
     is >> nsets;
 
     new_data.reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(),
-                                MFInfo().SetTag("StateData").SetArena(arena),
+                                MFInfo().SetTag("StateData").SetArena(arena).SetRecycle(true),
                                 *m_factory));
     old_data.reset();
+    m_old_packed.reset();
     if (nsets == 2) {
         old_data.reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(),
-                                    MFInfo().SetTag("StateData").SetArena(arena),
+                                    MFInfo().SetTag("StateData").SetArena(arena).SetRecycle(true),
                                     *m_factory));
     }
     //
@@ -287,8 +295,9 @@ StateData::restart (const StateDescriptor& d,
     new_time.start = rhs.new_time.start;
     new_time.stop  = rhs.new_time.stop;
     old_data.reset();
+    m_old_packed.reset();
     new_data.reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(),
-                                MFInfo().SetTag("StateData").SetArena(arena),
+                                MFInfo().SetTag("StateData").SetArena(arena).SetRecycle(true),
                                 *m_factory));
     new_data->setVal(0.);
 }
@@ -301,10 +310,11 @@ StateData::~StateData()
 void
 StateData::allocOldData ()
 {
+    m_old_packed.reset();
     if (old_data == nullptr)
     {
         old_data.reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(),
-                                    MFInfo().SetTag("StateData").SetArena(arena),
+                                    MFInfo().SetTag("StateData").SetArena(arena).SetRecycle(true),
                                     *m_factory));
     }
 }
@@ -393,12 +403,18 @@ StateData::swapTimeLevels (Real dt)
         new_time.start = new_time.stop;
         new_time.stop += dt;
     }
+    //
+    // The old data become the new data, which are about to be overwritten,
+    // so a compressed copy is dropped without decoding it.
+    //
+    if (m_old_packed != nullptr) allocOldData();
     std::swap(old_data, new_data);
 }
 
 void
 StateData::replaceOldData (MultiFab&& mf)
 {
+    m_old_packed.reset();
     old_data.reset(new MultiFab(std::move(mf)));
 }
 
@@ -407,6 +423,22 @@ StateData::replaceOldData (MultiFab&& mf)
 void
 StateData::replaceOldData (StateData& s)
 {
+    if (m_old_packed != nullptr && s.m_old_packed != nullptr)
+    {
+        //
+        // Both are compressed; exchange the compressed copies and drop the
+        // decoded ones, which no longer match.
+        //
+        BL_ASSERT(amrex::match(grids, s.grids) && dmap == s.dmap);
+        std::swap(m_old_packed, s.m_old_packed);
+        std::swap(m_cstats.raw_bytes, s.m_cstats.raw_bytes);
+        std::swap(m_cstats.packed_bytes, s.m_cstats.packed_bytes);
+        old_data.reset();
+        s.old_data.reset();
+        return;
+    }
+    uncompressOldData(true);
+    s.uncompressOldData(true);
     MultiFab::Swap(*old_data, *s.old_data, 0, 0, old_data->nComp(), old_data->nGrow());
 }
 
@@ -573,6 +605,7 @@ void
 StateData::RegisterData (MultiFabCopyDescriptor& multiFabCopyDesc,
                          Vector<MultiFabId>&      mfid)
 {
+    uncompressOldData(false);
     mfid.resize(2);
     mfid[MFNEWDATA] = multiFabCopyDesc.RegisterFabArray(new_data.get());
     mfid[MFOLDDATA] = multiFabCopyDesc.RegisterFabArray(old_data.get());
@@ -712,6 +745,8 @@ StateData::getData (Vector<MultiFab*>& data,
 		    Vector<Real>& datatime,
 		    Real time) const
 {
+    uncompressOldData(false);
+
     data.clear();
     datatime.clear();
 
@@ -768,12 +803,17 @@ StateData::checkPoint (const std::string& name,
                        const std::string& fullpathname,
                        std::ostream&  os,
                        VisMF::How     how,
-                       bool           dump_old)
+                       bool           dump_old,
+                       Vector<std::future<WriteAsyncStatus> >* async_writes)
 {
     BL_PROFILE("StateData::checkPoint()");
     static const std::string NewSuffix("_New_MF");
     static const std::string OldSuffix("_Old_MF");
 
+    // Only free what is decoded here; a decoded copy made by FillPatch is kept.
+    const bool decode_here = (m_old_packed != nullptr && old_data == nullptr);
+    uncompressOldData(false);
+
     if (dump_old == true && old_data == nullptr)
     {
         dump_old = false;
@@ -820,15 +860,97 @@ StateData::checkPoint (const std::string& name,
     {
        BL_ASSERT(new_data);
        std::string mf_fullpath_new(fullpathname + NewSuffix);
-       VisMF::Write(*new_data,mf_fullpath_new,how);
+       if (async_writes) {
+           async_writes->push_back(VisMF::WriteAsync(*new_data,mf_fullpath_new));
+       } else {
+           VisMF::Write(*new_data,mf_fullpath_new,how);
+       }
 
        if (dump_old)
        {
            BL_ASSERT(old_data);
            std::string mf_fullpath_old(fullpathname + OldSuffix);
-           VisMF::Write(*old_data,mf_fullpath_old,how);
+           if (async_writes) {
+               async_writes->push_back(VisMF::WriteAsync(*old_data,mf_fullpath_old));
+           } else {
+               VisMF::Write(*old_data,mf_fullpath_old,how);
+           }
        }
     }
+
+    if (decode_here) releaseDecodedOldData();
+}
+
+void
+StateData::compressOldData (Real tolerance)
+{
+    if (m_old_packed != nullptr) {
+        old_data.reset();
+        return;
+    }
+    if (old_data == nullptr) return;
+
+    BL_PROFILE("StateData::compressOldData()");
+
+    const Real strt_time = amrex::second();
+
+    std::unique_ptr<PackedData> packed(new PackedData);
+    packed->fabs.resize(old_data->local_size());
+
+    long raw_bytes = 0, packed_bytes = 0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:raw_bytes,packed_bytes)
+#endif
+    for (MFIter mfi(*old_data); mfi.isValid(); ++mfi)
+    {
+        const FArrayBox& fab = (*old_data)[mfi];
+        Vector<char>& buf = packed->fabs[mfi.LocalIndex()];
+        FabCompress::Encode(fab.dataPtr(), fab.box().numPts()*fab.nComp(), tolerance, buf);
+        buf.shrink_to_fit();
+        raw_bytes    += fab.nBytes();
+        packed_bytes += buf.size();
+    }
+
+    m_cstats.raw_bytes = raw_bytes;
+    m_cstats.packed_bytes = packed_bytes;
+    ++m_cstats.nencodes;
+    m_cstats.encode_time += amrex::second() - strt_time;
+
+    m_old_packed = std::move(packed);
+    old_data.reset();
+}
+
+void
+StateData::uncompressOldData (bool discard_packed) const
+{
+    if (m_old_packed == nullptr) return;
+
+    if (old_data == nullptr)
+    {
+        BL_PROFILE("StateData::uncompressOldData()");
+
+        const Real strt_time = amrex::second();
+
+        old_data.reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(),
+                                    MFInfo().SetTag("StateData").SetArena(arena).SetRecycle(true),
+                                    *m_factory));
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(*old_data); mfi.isValid(); ++mfi)
+        {
+            FArrayBox& fab = (*old_data)[mfi];
+            const Vector<char>& buf = m_old_packed->fabs[mfi.LocalIndex()];
+            FabCompress::Decode(buf.data(), buf.size(), fab.dataPtr(), fab.box().numPts()*fab.nComp());
+        }
+
+        ++m_cstats.ndecodes;
+        m_cstats.decode_time += amrex::second() - strt_time;
+    }
+
+    if (discard_packed) {
+        m_old_packed.reset();
+    }
 }
 
 void
@@ -73,6 +73,7 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
     use_fixed_upto_level   = 0;
     refine_grid_layout     = true;
     check_input            = true;
+    pack_tags              = true;
 
     use_new_chop         = false;
     iterate_on_new_grids = true;
@@ -373,6 +374,8 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
 
     pp.query("check_input", check_input);
 
+    pp.query("pack_tags", pack_tags);
+
     finest_level = -1;
 
     if (check_input) checkInput();
@@ -588,6 +591,10 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         if ( ! (useFixedCoarseGrids() && levc < useFixedUpToLevel()) ) {
 	    ErrorEst(levc, tags, time, ngrow);
 	}
+        //
+        // Store the tags as bits, freeing the TagBoxes, until they are collated.
+        //
+        if (pack_tags) tags.pack();
 
         //
         // If new grids have been constructed above this level, project
@@ -690,6 +697,11 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
             amrex::Abort("blocking factor is too small relative to ref_ratio");
         }
         //
+        // ManualTagsPlacement and mapPeriodic need the TagBoxes, which are
+        // now coarsened by the blocking factor.
+        //
+        tags.unpack();
+        //
         // Remove or add tagged points which violate/satisfy additional
         // user-specified criteria.
         //
@@ -701,6 +713,8 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
                                   Geom(levc).ProbDomain(),
                                   Geom(levc).CoordInt(),
                                   Geom(levc).isPeriodic()));
+
+        if (pack_tags) tags.pack();
         //
         // Remove cells outside proper nesting domain for this level.
         //
@@ -12,13 +12,13 @@ namespace amrex {
 //
 // PCInterp, NodeBilinear, and CellConservativeLinear are supported for all dimensions on cpu and gpu.
 //
-// CellConsertiveProtected only works in 2D and 3D on cpu.
+// CellConsertiveProtected only works in 2D and 3D on cpu and gpu.
 //
 // CellBilinear works in 1D, 2D and 3D on cpu.
 //
-// CellQuadratic only works in 2D on cpu.
+// CellQuadratic only works in 2D on cpu and gpu.
 //
-// CellConservativeQuartic only works with ref ratio of 2 on cpu
+// CellConservativeQuartic only works with ref ratio of 2 on cpu and gpu.
 //
 
 //
@@ -388,95 +388,51 @@ CellQuadratic::interp (const FArrayBox& crse,
                        const Geometry&  crse_geom,
                        const Geometry&  fine_geom,
                        Vector<BCRec> const&  bcr,
-                       int              actual_comp,
-                       int              actual_state,
+                       int              /*actual_comp*/,
+                       int              /*actual_state*/,
                        RunOn            runon)
 {
     BL_PROFILE("CellQuadratic::interp()");
     BL_ASSERT(bcr.size() >= ncomp);
+
+#if (AMREX_SPACEDIM == 2)
+    bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
+
     //
     // Make box which is intersection of fine_region and domain of fine.
     //
     Box target_fine_region = fine_region & fine.box();
 
     Box crse_bx(amrex::coarsen(target_fine_region,ratio));
-    Box fslope_bx(amrex::refine(crse_bx,ratio));
-    Box cslope_bx(crse_bx);
-    cslope_bx.grow(1);
-    BL_ASSERT(crse.box().contains(cslope_bx));
-    //
-    // Alloc temp space for coarse grid slopes: here we use 5
-    // instead of AMREX_SPACEDIM because of the x^2, y^2 and xy terms
-    //
-    long t_long = cslope_bx.numPts();
-    BL_ASSERT(t_long < INT_MAX);
-    int c_len = int(t_long);
+    BL_ASSERT(crse.box().contains(amrex::grow(crse_bx,1)));
 
-    Vector<Real> cslope(5*c_len);
+    Array4<Real const> const& crsearr = crse.const_array();
+    Array4<Real> const& finearr = fine.array();
 
-    int loslp = cslope_bx.index(crse_bx.smallEnd());
-    int hislp = cslope_bx.index(crse_bx.bigEnd());
+    AsyncArray<BCRec> async_bcr(bcr.data(), (run_on_gpu) ? ncomp : 0);
+    BCRec const* bcrp = (run_on_gpu) ? async_bcr.data() : bcr.data();
 
-    t_long = cslope_bx.numPts();
-    BL_ASSERT(t_long < INT_MAX);
-    int cslope_vol = int(t_long);
-    int clo        = 1 - loslp;
-    int chi        = clo + cslope_vol - 1;
-    c_len          = hislp - loslp + 1;
-    //
-    // Alloc temp space for one strip of fine grid slopes: here we use 5
-    // instead of AMREX_SPACEDIM because of the x^2, y^2 and xy terms.
-    //
-    int dir;
-    int f_len = fslope_bx.longside(dir);
+    const Vector<Real>& vec_voff = amrex::ccinterp_compute_voff(crse_bx, ratio, crse_geom, fine_geom);
 
-    Vector<Real> strip((5+2)*f_len);
+    AsyncArray<Real> async_voff(vec_voff.data(), (run_on_gpu) ? vec_voff.size() : 0);
+    Real const* voff = (run_on_gpu) ? async_voff.data() : vec_voff.data();
 
-    Real* fstrip = strip.dataPtr();
-    Real* foff   = fstrip + f_len;
-    Real* fslope = foff + f_len;
-    //
-    // Get coarse and fine edge-centered volume coordinates.
-    //
-    Vector<Real> fvc[AMREX_SPACEDIM];
-    Vector<Real> cvc[AMREX_SPACEDIM];
-    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
+    if (run_on_gpu)
+    {
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG ( run_on_gpu, target_fine_region, tbx,
+        {
+            amrex::cqinterp_interp(tbx, crse_bx, finearr, fine_comp, ncomp, crsearr, crse_comp,
+                                   voff, ratio, bcrp);
+        });
+    }
+    else
     {
-        fine_geom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
-        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
+        amrex::cqinterp_interp_rows(target_fine_region, crse_bx, finearr, fine_comp, ncomp,
+                                    crsearr, crse_comp, voff, ratio, bcrp);
     }
-    //
-    // Alloc tmp space for slope calc and to allow for vectorization.
-    //
-    Real* fdat        = fine.dataPtr(fine_comp);
-    const Real* cdat  = crse.dataPtr(crse_comp);
-    const int* flo    = fine.loVect();
-    const int* fhi    = fine.hiVect();
-    const int* fblo   = target_fine_region.loVect();
-    const int* fbhi   = target_fine_region.hiVect();
-    const int* cblo   = crse_bx.loVect();
-    const int* cbhi   = crse_bx.hiVect();
-    const int* fslo   = fslope_bx.loVect();
-    const int* fshi   = fslope_bx.hiVect();
-    int slope_flag    = (do_limited_slope ? 1 : 0);
-    Vector<int> bc     = GetBCArray(bcr);
-    const int* ratioV = ratio.getVect();
-
-#if (AMREX_SPACEDIM > 1)
-
-    amrex_cqinterp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
-                   AMREX_ARLIM(fblo), AMREX_ARLIM(fbhi),
-                   &ncomp,AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-                   cdat,&clo,&chi,
-                   AMREX_ARLIM(cblo), AMREX_ARLIM(cbhi),
-                   fslo,fshi,
-                   cslope.dataPtr(),&c_len,fslope,fstrip,&f_len,foff,
-                   bc.dataPtr(), &slope_flag,
-                   AMREX_D_DECL(fvc[0].dataPtr(),fvc[1].dataPtr(),fvc[2].dataPtr()),
-                   AMREX_D_DECL(cvc[0].dataPtr(),cvc[1].dataPtr(),cvc[2].dataPtr()),
-                   &actual_comp,&actual_state);
-
-#endif /*(AMREX_SPACEDIM > 1)*/
+#elif (AMREX_SPACEDIM == 3)
+    amrex::Abort("CellQuadratic::interp: quadratic interpolation is not implemented in 3D");
+#endif
 }
 
 PCInterp::~PCInterp () {}
@@ -607,8 +563,8 @@ CellConservativeProtected::interp (const FArrayBox& crse,
 }
 
 void
-CellConservativeProtected::protect (const FArrayBox& crse,
-                                    int              crse_comp,
+CellConservativeProtected::protect (const FArrayBox& /*crse*/,
+                                    int              /*crse_comp*/,
                                     FArrayBox&       fine,
                                     int              fine_comp,
                                     FArrayBox&       fine_state,
@@ -624,6 +580,9 @@ CellConservativeProtected::protect (const FArrayBox& crse,
     BL_PROFILE("CellConservativeProtected::protect()");
     BL_ASSERT(bcr.size() >= ncomp);
 
+#if (AMREX_SPACEDIM > 1)
+    bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
+
     //
     // Make box which is intersection of fine_region and domain of fine.
     //
@@ -640,68 +599,25 @@ CellConservativeProtected::protect (const FArrayBox& crse,
     Box cs_bx(crse_bx);
     cs_bx.grow(-1);
 
-    //
-    // Get coarse and fine edge-centered volume coordinates.
-    //
-    int dir;
-    Vector<Real> fvc[AMREX_SPACEDIM];
-    Vector<Real> cvc[AMREX_SPACEDIM];
-    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
-    {
-        fine_geom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
-        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
-    }
+    Array4<Real> const& finearr = fine.array();
+    Array4<Real const> const& statearr = fine_state.const_array();
 
 #if (AMREX_SPACEDIM == 2)
-    const int* cvcblo = crse_bx.loVect();
-    const int* fvcblo = target_fine_region.loVect();
-
-    int cvcbhi[AMREX_SPACEDIM];
-    int fvcbhi[AMREX_SPACEDIM];
-
-    for (dir=0; dir<AMREX_SPACEDIM; dir++)
-    {
-        cvcbhi[dir] = cvcblo[dir] + cvc[dir].size() - 1;
-        fvcbhi[dir] = fvcblo[dir] + fvc[dir].size() - 1;
-    }
+    const Vector<Real>& vec_dv = amrex::ccprotect_compute_dv(target_fine_region, crse_bx,
+                                                             crse_geom, fine_geom);
+#else
+    const Vector<Real> vec_dv;
 #endif
 
-    Real* fdat       = fine.dataPtr(fine_comp);
-    Real* state_dat  = fine_state.dataPtr(state_comp);
-    const Real* cdat = crse.dataPtr(crse_comp);
-
-    const int* flo    = fine.loVect();
-    const int* fhi    = fine.hiVect();
-    const int* slo    = fine_state.loVect();
-    const int* shi    = fine_state.hiVect();
-    const int* clo    = crse.loVect();
-    const int* chi    = crse.hiVect();
-    const int* fblo   = target_fine_region.loVect();
-    const int* fbhi   = target_fine_region.hiVect();
-    const int* csbhi  = cs_bx.hiVect();
-    const int* csblo  = cs_bx.loVect();
-
-    Vector<int> bc     = GetBCArray(bcr);
-    const int* ratioV = ratio.getVect();
+    AsyncArray<Real> async_dv(vec_dv.data(), (run_on_gpu) ? vec_dv.size() : 0);
+    Real const* dv = (run_on_gpu) ? async_dv.data() : vec_dv.data();
 
-#if (AMREX_SPACEDIM > 1)
-
-    amrex_protect_interp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
-                         fblo, fbhi,
-                         cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),
-                         csblo, csbhi,
-#if (AMREX_SPACEDIM == 2)
-                         fvc[0].dataPtr(),fvc[1].dataPtr(),
-                         AMREX_ARLIM(fvcblo), AMREX_ARLIM(fvcbhi),
-                         cvc[0].dataPtr(),cvc[1].dataPtr(),
-                         AMREX_ARLIM(cvcblo), AMREX_ARLIM(cvcbhi),
+    AMREX_HOST_DEVICE_FOR_3D_FLAG ( run_on_gpu, cs_bx, ic, jc, kc,
+    {
+        amrex::ccprotect_interp(ic, jc, kc, target_fine_region, crse_bx, ratio,
+                                finearr, fine_comp, statearr, state_comp, ncomp, dv);
+    });
 #endif
-                         state_dat, AMREX_ARLIM(slo), AMREX_ARLIM(shi),
-                         &ncomp,AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-                         bc.dataPtr());
-
-#endif /*(AMREX_SPACEDIM > 1)*/
-
 }
 
 CellConservativeQuartic::~CellConservativeQuartic () {}
@@ -735,19 +651,18 @@ CellConservativeQuartic::interp (const FArrayBox&  crse,
 				 const Geometry&   /* crse_geom */,
 				 const Geometry&   /* fine_geom */,
 				 Vector<BCRec> const&   bcr,
-				 int               actual_comp,
-				 int               actual_state,
+				 int               /*actual_comp*/,
+				 int               /*actual_state*/,
                                  RunOn             runon)
 {
     BL_PROFILE("CellConservativeQuartic::interp()");
     BL_ASSERT(bcr.size() >= ncomp);
-    BL_ASSERT(ratio[0]==2);
-#if (AMREX_SPACEDIM >= 2)
-    BL_ASSERT(ratio[0] == ratio[1]);
-#endif
-#if (AMREX_SPACEDIM == 3)
-    BL_ASSERT(ratio[1] == ratio[2]);
-#endif
+
+    if (ratio != 2) {
+        amrex::Abort("CellConservativeQuartic::interp: only refinement ratio 2 is supported");
+    }
+
+    bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
 
     //
     // Make box which is intersection of fine_region and domain of fine.
@@ -757,51 +672,46 @@ CellConservativeQuartic::interp (const FArrayBox&  crse,
     // crse_bx is coarsening of target_fine_region, grown by 2.
     //
     Box crse_bx = CoarseBox(target_fine_region,ratio);
+    BL_ASSERT(crse.box().contains(crse_bx));
 
-    Box crse_bx2(crse_bx);
-    crse_bx2.grow(-2);
-    Box fine_bx2 = amrex::refine(crse_bx2,ratio);
-
-    Real* fdat       = fine.dataPtr(fine_comp);
-    const Real* cdat = crse.dataPtr(crse_comp);
-
-    const int* flo    = fine.loVect();
-    const int* fhi    = fine.hiVect();
-    const int* clo    = crse.loVect();
-    const int* chi    = crse.hiVect();
-    const int* fblo   = target_fine_region.loVect();
-    const int* fbhi   = target_fine_region.hiVect();
-    const int* cblo   = crse_bx.loVect();
-    const int* cbhi   = crse_bx.hiVect();
-    const int* cb2lo  = crse_bx2.loVect();
-    const int* cb2hi  = crse_bx2.hiVect();
-    const int* fb2lo  = fine_bx2.loVect();
-    const int* fb2hi  = fine_bx2.hiVect();
-
-    Vector<int> bc     = GetBCArray(bcr);
-    const int* ratioV = ratio.getVect();
+    //
+    // The interpolation is separable.  Refine one direction at a time,
+    // starting with the last, into temporaries that are fine in the
+    // directions done so far and cover crse_bx in the others.
+    //
+    FArrayBox tmp[AMREX_SPACEDIM];
+    Elixir    tmpeli[AMREX_SPACEDIM];
 
-    int ltmp = fb2hi[0]-fb2lo[0]+1;
-    Vector<Real> ftmp(ltmp);
+    Array4<Real const> src = crse.const_array();
+    int scomp = crse_comp;
 
-#if (AMREX_SPACEDIM >= 2)
-    ltmp = (cbhi[0]-cblo[0]+1)*ratio[1];
-    Vector<Real> ctmp(ltmp);
-#endif
+    for (int dir = AMREX_SPACEDIM-1; dir >= 0; --dir)
+    {
+        Box bx = target_fine_region;
+        for (int d = 0; d < dir; ++d) {
+            bx.setRange(d, crse_bx.smallEnd(d), crse_bx.length(d));
+        }
 
-#if (AMREX_SPACEDIM == 3)
-    ltmp = (cbhi[0]-cblo[0]+1)*(cbhi[1]-cblo[1]+1)*ratio[2];
-    Vector<Real> ctmp2(ltmp);
-#endif
+        Array4<Real> dst;
+        int dcomp;
+        if (dir > 0) {
+            tmp[dir].resize(bx, ncomp);
+            if (run_on_gpu) tmpeli[dir] = tmp[dir].elixir();
+            dst = tmp[dir].array();
+            dcomp = 0;
+        } else {
+            dst = fine.array();
+            dcomp = fine_comp;
+        }
 
-    amrex_quartinterp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
-		      fblo, fbhi, fb2lo, fb2hi,
-		      cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),
-		      cblo, cbhi, cb2lo, cb2hi,
-		      &ncomp,
-		      AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-		      AMREX_D_DECL(ftmp.dataPtr(), ctmp.dataPtr(), ctmp2.dataPtr()),
-		      bc.dataPtr(),&actual_comp,&actual_state);
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG ( run_on_gpu, bx, tbx,
+        {
+            amrex::quartinterp_dir(tbx, dir, dst, dcomp, src, scomp, ncomp);
+        });
+
+        src = tmp[dir].const_array();
+        scomp = 0;
+    }
 }
 
 }
@@ -468,7 +468,13 @@ TagBoxArray::buffer (const IntVect& nbuf)
 #pragma omp parallel
 #endif
        for (MFIter mfi(*this); mfi.isValid(); ++mfi)
-           get(mfi).buffer(nbuf, n_grow);
+       {
+           if (m_packed) {
+               m_bits[mfi.LocalIndex()].buffer(nbuf, n_grow);
+           } else {
+               get(mfi).buffer(nbuf, n_grow);
+           }
+       }
     }
 }
 
@@ -483,6 +489,8 @@ TagBoxArray::mapPeriodic (const Geometry& geom)
     // So we can assume that n_grow is 0.
     BL_ASSERT(n_grow[0] == 0);
 
+    unpack();
+
     TagBoxArray tmp(boxArray(),DistributionMap()); // note that tmp is filled w/ CLEAR.
 
     tmp.copy(*this, geom.periodicity(), FabArrayBase::ADD);
@@ -510,7 +518,7 @@ TagBoxArray::numTags () const
 #endif
     for (MFIter mfi(*this); mfi.isValid(); ++mfi)
     {
-	ntag += get(mfi).numTags();
+	ntag += m_packed ? m_bits[mfi.LocalIndex()].numTags() : get(mfi).numTags();
     }
     
     ParallelDescriptor::ReduceLongSum(ntag);
@@ -532,7 +540,7 @@ TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
 #endif
     for (MFIter fai(*this); fai.isValid(); ++fai)
     {
-        count += get(fai).numTags();
+        count += m_packed ? m_bits[fai.LocalIndex()].numTags() : get(fai).numTags();
     }
 
     //
@@ -545,7 +553,11 @@ TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
     // unsafe to do OMP
     for (MFIter fai(*this); fai.isValid(); ++fai)
     {
-        count += get(fai).collate(TheLocalCollateSpace,count);
+        if (m_packed) {
+            count += m_bits[fai.LocalIndex()].collate(TheLocalCollateSpace,count);
+        } else {
+            count += get(fai).collate(TheLocalCollateSpace,count);
+        }
     }
 
     if (count > 0)
@@ -649,11 +661,23 @@ TagBoxArray::setVal (const BoxArray& ba,
 
         ba.intersections(mfi.fabbox(),isects);
 
-        TagBox& tags = get(mfi);
+        if (m_packed)
+        {
+            BitFab& bits = m_bits[mfi.LocalIndex()];
 
-        for (int i = 0, N = isects.size(); i < N; i++)
+            for (int i = 0, N = isects.size(); i < N; i++)
+            {
+                bits.setVal(val != TagBox::CLEAR, isects[i].second);
+            }
+        }
+        else
         {
-            tags.setVal(val,isects[i].second,0);
+            TagBox& tags = get(mfi);
+
+            for (int i = 0, N = isects.size(); i < N; i++)
+            {
+                tags.setVal(val,isects[i].second,0);
+            }
         }
     }
 }
@@ -672,7 +696,11 @@ TagBoxArray::coarsen (const IntVect & ratio)
 #endif
     for (MFIter mfi(*this,flags); mfi.isValid(); ++mfi)
     {
-        this->fabPtr(mfi)->coarsen(ratio);
+        if (m_packed) {
+            m_bits[mfi.LocalIndex()].coarsen(ratio);
+        } else {
+            this->fabPtr(mfi)->coarsen(ratio);
+        }
     }
 
     boxarray.growcoarsen(n_grow,ratio);
@@ -681,5 +709,55 @@ TagBoxArray::coarsen (const IntVect & ratio)
     n_grow = IntVect::TheZeroVector();
 }
 
+void
+TagBoxArray::pack ()
+{
+    if (m_packed || SharedMemory() || ParallelDescriptor::TeamSize() > 1) return;
+
+    BL_PROFILE("TagBoxArray::pack()");
+
+    Gpu::LaunchSafeGuard lsg(false); // xxxxx TODO: gpu
+
+    m_bits.clear();
+    m_bits.resize(local_size());
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(*this); mfi.isValid(); ++mfi)
+    {
+        TagBox& fab = get(mfi);
+        m_bits[mfi.LocalIndex()] = BitFab(fab, TagType(TagBox::CLEAR));
+        fab.clear();
+    }
+
+    m_packed = true;
+}
+
+void
+TagBoxArray::unpack ()
+{
+    if (!m_packed) return;
+
+    BL_PROFILE("TagBoxArray::unpack()");
+
+    Gpu::LaunchSafeGuard lsg(false); // xxxxx TODO: gpu
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(*this); mfi.isValid(); ++mfi)
+    {
+        BitFab& bits = m_bits[mfi.LocalIndex()];
+        TagBox& fab = get(mfi);
+        fab.resize(bits.box(),1);
+        bits.copyTo(fab, TagType(TagBox::SET), TagType(TagBox::CLEAR));
+        bits.clear();
+    }
+
+    m_bits.clear();
+    m_packed = false;
+}
+
 }
 
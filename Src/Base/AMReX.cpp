@@ -20,6 +20,9 @@
 #include <AMReX_Random.H>
 #include <AMReX_Print.H>
 #include <AMReX_Arena.H>
+#include <AMReX_FabFactory.H>
+#include <AMReX_FabSpiller.H>
+#include <AMReX_TileSizeTuner.H>
 
 #include <AMReX_Gpu.H>
 
@@ -488,6 +491,8 @@ amrex::Initialize (int& argc, char**& argv, bool build_parm_parse,
     amrex::InitRandom(ParallelDescriptor::MyProc()+1, ParallelDescriptor::NProcs());
 
     Arena::Initialize();
+    FabRecycler::Initialize();
+    FabSpiller::Initialize();
     amrex_mempool_init();
 
     // For thread safety, we should do these initializations here.
@@ -497,6 +502,7 @@ amrex::Initialize (int& argc, char**& argv, bool build_parm_parse,
     FArrayBox::Initialize();
     IArrayBox::Initialize();
     FabArrayBase::Initialize();
+    TileSizeTuner::Initialize();
     MultiFab::Initialize();
     iMultiFab::Initialize();
     VisMF::Initialize();
@@ -4,6 +4,8 @@
 #include <AMReX_CArena.H>
 #include <AMReX_DArena.H>
 #include <AMReX_EArena.H>
+#include <AMReX_TArena.H>
+#include <AMReX_HArena.H>
 
 #include <AMReX.H>
 #include <AMReX_Print.H>
@@ -26,6 +28,14 @@ namespace {
 
     bool use_buddy_allocator = false;
     long buddy_allocator_size = 0L;
+    bool use_thread_caching_arena = false;
+    long thread_caching_arena_max_cached_size = TArena::DefaultMaxCachedSize;
+    long thread_caching_arena_max_thread_cache = TArena::DefaultMaxThreadCache;
+    bool use_huge_page_arena = false;
+    bool huge_page_arena_use_hugetlb = false;
+    long huge_page_arena_hunk_size = HArena::DefaultHugeHunkSize;
+    std::string huge_page_arena_numa_policy = "none";
+    int huge_page_arena_numa_node = 0;
     long the_arena_init_size = 0L;
     bool abort_on_out_of_gpu_memory = false;
 }
@@ -130,9 +140,22 @@ Arena::Initialize ()
     ParmParse pp("amrex");
     pp.query("use_buddy_allocator", use_buddy_allocator);
     pp.query("buddy_allocator_size", buddy_allocator_size);
+    pp.query("use_thread_caching_arena", use_thread_caching_arena);
+    pp.query("thread_caching_arena_max_cached_size", thread_caching_arena_max_cached_size);
+    pp.query("thread_caching_arena_max_thread_cache", thread_caching_arena_max_thread_cache);
+    pp.query("use_huge_page_arena", use_huge_page_arena);
+    pp.query("huge_page_arena_use_hugetlb", huge_page_arena_use_hugetlb);
+    pp.query("huge_page_arena_hunk_size", huge_page_arena_hunk_size);
+    pp.query("huge_page_arena_numa_policy", huge_page_arena_numa_policy);
+    pp.query("huge_page_arena_numa_node", huge_page_arena_numa_node);
     pp.query("the_arena_init_size", the_arena_init_size);
     pp.query("abort_on_out_of_gpu_memory", abort_on_out_of_gpu_memory);
 
+    if (use_huge_page_arena && use_thread_caching_arena) {
+        amrex::Abort("amrex.use_huge_page_arena and amrex.use_thread_caching_arena "
+                     "cannot both be enabled");
+    }
+
 #ifdef AMREX_USE_GPU
     if (use_buddy_allocator)
     {
@@ -156,7 +179,16 @@ Arena::Initialize ()
         the_arena->free(p);
 #endif
 #else
-        the_arena = new BArena;
+        if (use_huge_page_arena) {
+            the_arena = new HArena(huge_page_arena_hunk_size, huge_page_arena_use_hugetlb,
+                                   HArena::numaPolicy(huge_page_arena_numa_policy),
+                                   huge_page_arena_numa_node);
+        } else if (use_thread_caching_arena) {
+            the_arena = new TArena(thread_caching_arena_max_cached_size,
+                                   thread_caching_arena_max_thread_cache);
+        } else {
+            the_arena = new BArena;
+        }
 #endif
     }
 
@@ -234,6 +266,14 @@ Arena::PrintUsage ()
             amrex::Print() << "[The         Arena] space (MB): " << min_megabytes << "\n";
 #endif
         }
+        HArena* h = dynamic_cast<HArena*>(The_Arena());
+        if (h) {
+            h->PrintStats("The         Arena");
+        }
+        TArena* t = dynamic_cast<TArena*>(The_Arena());
+        if (t) {
+            t->PrintStats("The         Arena");
+        }
     }
     if (The_Device_Arena()) {
         CArena* p = dynamic_cast<CArena*>(The_Device_Arena());
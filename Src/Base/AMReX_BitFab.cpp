@@ -0,0 +1,322 @@
+
+#include <algorithm>
+
+#include <AMReX_BitFab.H>
+
+namespace amrex {
+
+namespace {
+
+    using Word = BitFab::Word;
+
+    inline int popcount (Word w) noexcept
+    {
+#if defined(__GNUC__)
+        return __builtin_popcountll(w);
+#else
+        int n = 0;
+        for (; w != 0; w &= w-1) ++n;
+        return n;
+#endif
+    }
+
+    inline int ctz (Word w) noexcept
+    {
+#if defined(__GNUC__)
+        return __builtin_ctzll(w);
+#else
+        int n = 0;
+        for (; (w & 1) == 0; w >>= 1) ++n;
+        return n;
+#endif
+    }
+
+    //! Mask of the bits [b0,b1) of a word, 0 <= b0 <= b1 <= 64.
+    inline Word bit_range (int b0, int b1) noexcept
+    {
+        const Word hi = (b1 >= 64) ? ~Word(0) : ((Word(1) << b1) - 1);
+        const Word lo = (b0 >= 64) ? ~Word(0) : ((Word(1) << b0) - 1);
+        return hi & ~lo;
+    }
+
+    //! Set or clear the bits [p0,p1) of a row.
+    void set_range (Word* row, int p0, int p1, bool v) noexcept
+    {
+        for (int w = p0/64; w*64 < p1; ++w) {
+            const Word m = bit_range(std::max(p0-w*64,0), std::min(p1-w*64,64));
+            if (v) {
+                row[w] |= m;
+            } else {
+                row[w] &= ~m;
+            }
+        }
+    }
+
+    //! The n <= 64 bits of a row starting at bit p, as the low bits of a word.
+    inline Word get_bits (const Word* row, int p, int n) noexcept
+    {
+        const int w = p/64, b = p%64;
+        Word v = row[w] >> b;
+        if (b != 0 && b+n > 64) v |= row[w+1] << (64-b);
+        return (n >= 64) ? v : (v & ((Word(1) << n) - 1));
+    }
+
+    //! OR the low n <= 64 bits of v into a row starting at bit p.
+    inline void or_bits (Word* row, int p, int n, Word v) noexcept
+    {
+        if (n < 64) v &= (Word(1) << n) - 1;
+        const int w = p/64, b = p%64;
+        row[w] |= v << b;
+        if (b != 0 && b+n > 64) row[w+1] |= v >> (64-b);
+    }
+
+    //! Set the neighbors in i of every set bit of a row of nbits bits.
+    void dilate_row (Word* row, int nwords, int nbits) noexcept
+    {
+        Word prev = 0;
+        for (int w = 0; w < nwords; ++w) {
+            const Word cur  = row[w];
+            const Word next = (w+1 < nwords) ? row[w+1] : 0;
+            row[w] = cur | (cur << 1) | (prev >> 63) | (cur >> 1) | (next << 63);
+            prev = cur;
+        }
+        row[nwords-1] &= bit_range(0, nbits-64*(nwords-1));
+    }
+}
+
+BitFab::BitFab (const Box& bx)
+{
+    define(bx);
+}
+
+void
+BitFab::define (const Box& bx)
+{
+    BL_ASSERT(bx.ok());
+    m_box = bx;
+    m_lo = amrex::lbound(bx);
+    const Dim3 len = amrex::length(bx);
+    m_nx = len.x;
+    m_ny = len.y;
+    m_nz = len.z;
+    m_nwords = (m_nx+63)/64;
+    m_words.assign(std::size_t(m_nwords)*m_ny*m_nz, 0);
+}
+
+void
+BitFab::clear () noexcept
+{
+    std::vector<Word>().swap(m_words);
+}
+
+void
+BitFab::setVal (bool v) noexcept
+{
+    if (v) {
+        setVal(v, m_box);
+    } else {
+        std::fill(m_words.begin(), m_words.end(), 0);
+    }
+}
+
+void
+BitFab::setVal (bool v, const Box& bx) noexcept
+{
+    const Box b = bx & m_box;
+    if (!b.ok()) return;
+    const Dim3 lo = amrex::lbound(b);
+    const Dim3 hi = amrex::ubound(b);
+    for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+            set_range(rowPtr(j,k), lo.x-m_lo.x, hi.x-m_lo.x+1, v);
+        }
+    }
+}
+
+void
+BitFab::merge (const BitFab& src) noexcept
+{
+    const Box b = m_box & src.m_box;
+    if (!b.ok()) return;
+    const Dim3 lo = amrex::lbound(b);
+    const Dim3 hi = amrex::ubound(b);
+    const int n  = hi.x-lo.x+1;
+    const int dp = lo.x-m_lo.x;
+    const int sp = lo.x-src.m_lo.x;
+    for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+            const Word* s = src.rowPtr(j,k);
+            Word*       d = rowPtr(j,k);
+            for (int p = 0; p < n; p += 64) {
+                const int m = std::min(64, n-p);
+                const Word v = get_bits(s, sp+p, m);
+                if (v != 0) or_bits(d, dp+p, m, v);
+            }
+        }
+    }
+}
+
+void
+BitFab::buffer (const IntVect& nbuf, const IntVect& nwid)
+{
+    const Box inside = amrex::grow(m_box,-nwid);
+    if (!inside.ok()) return;
+
+    //
+    // Dilate the bits of the interior one direction at a time.
+    //
+    BitFab d(m_box);
+    {
+        BitFab tmp(inside);
+        tmp.merge(*this);
+        d.merge(tmp);
+    }
+
+    Dim3 nb{0,0,0};
+    AMREX_D_TERM(nb.x = nbuf[0];, nb.y = nbuf[1];, nb.z = nbuf[2];)
+
+    const long nrows = long(m_ny)*m_nz;
+    for (int s = 0; s < nb.x; ++s) {
+        for (long r = 0; r < nrows; ++r) {
+            dilate_row(d.m_words.data()+r*m_nwords, m_nwords, m_nx);
+        }
+    }
+
+    if (nb.y > 0)
+    {
+        std::vector<Word> plane(std::size_t(m_nwords)*m_ny);
+        for (int k = 0; k < m_nz; ++k)
+        {
+            Word* p = d.m_words.data() + std::size_t(k)*m_ny*m_nwords;
+            std::copy(p, p+plane.size(), plane.begin());
+            for (int j = 0; j < m_ny; ++j) {
+                Word* row = p + std::size_t(j)*m_nwords;
+                for (int jj = std::max(j-nb.y,0); jj <= std::min(j+nb.y,m_ny-1); ++jj) {
+                    const Word* src = plane.data() + std::size_t(jj)*m_nwords;
+                    for (int w = 0; w < m_nwords; ++w) row[w] |= src[w];
+                }
+            }
+        }
+    }
+
+    if (nb.z > 0)
+    {
+        const std::size_t nplane = std::size_t(m_nwords)*m_ny;
+        const std::vector<Word> orig(d.m_words);
+        for (int k = 0; k < m_nz; ++k) {
+            Word* p = d.m_words.data() + k*nplane;
+            for (int kk = std::max(k-nb.z,0); kk <= std::min(k+nb.z,m_nz-1); ++kk) {
+                const Word* src = orig.data() + kk*nplane;
+                for (std::size_t w = 0; w < nplane; ++w) p[w] |= src[w];
+            }
+        }
+    }
+
+    for (std::size_t w = 0; w < m_words.size(); ++w) {
+        m_words[w] |= d.m_words[w];
+    }
+}
+
+void
+BitFab::coarsen (const IntVect& ratio)
+{
+    Dim3 r{1,1,1};
+    AMREX_D_TERM(r.x = ratio[0];, r.y = ratio[1];, r.z = ratio[2];)
+
+    const Box cbox = amrex::coarsen(m_box,ratio);
+    BitFab c(cbox);
+
+    const Dim3 hi  = amrex::ubound(m_box);
+    const Dim3 clo = amrex::lbound(cbox);
+    const Dim3 chi = amrex::ubound(cbox);
+
+    std::vector<Word> tmp(m_nwords);
+    for (int kc = clo.z; kc <= chi.z; ++kc) {
+        for (int jc = clo.y; jc <= chi.y; ++jc)
+        {
+            //
+            // OR the fine rows of this coarse row, then compress in i.
+            //
+            std::fill(tmp.begin(), tmp.end(), 0);
+            bool any = false;
+            for (int k = std::max(kc*r.z,m_lo.z); k <= std::min(kc*r.z+r.z-1,hi.z); ++k) {
+                for (int j = std::max(jc*r.y,m_lo.y); j <= std::min(jc*r.y+r.y-1,hi.y); ++j) {
+                    const Word* row = rowPtr(j,k);
+                    for (int w = 0; w < m_nwords; ++w) {
+                        tmp[w] |= row[w];
+                        any = any || (row[w] != 0);
+                    }
+                }
+            }
+            if (!any) continue;
+
+            Word* crow = c.rowPtr(jc,kc);
+            for (int ic = clo.x; ic <= chi.x; ++ic) {
+                const int p0 = std::max(ic*r.x,m_lo.x) - m_lo.x;
+                const int p1 = std::min(ic*r.x+r.x-1,hi.x) - m_lo.x + 1;
+                for (int p = p0; p < p1; p += 64) {
+                    if (get_bits(tmp.data(), p, std::min(64,p1-p)) != 0) {
+                        const int b = ic-clo.x;
+                        crow[b/64] |= Word(1) << (b%64);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    *this = std::move(c);
+}
+
+long
+BitFab::numTags () const noexcept
+{
+    long n = 0;
+    for (Word w : m_words) {
+        n += popcount(w);
+    }
+    return n;
+}
+
+long
+BitFab::numTags (const Box& bx) const noexcept
+{
+    const Box b = bx & m_box;
+    if (!b.ok()) return 0;
+    const Dim3 lo = amrex::lbound(b);
+    const Dim3 hi = amrex::ubound(b);
+    const int n  = hi.x-lo.x+1;
+    const int p0 = lo.x-m_lo.x;
+    long nt = 0;
+    for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+            const Word* row = rowPtr(j,k);
+            for (int p = 0; p < n; p += 64) {
+                nt += popcount(get_bits(row, p0+p, std::min(64,n-p)));
+            }
+        }
+    }
+    return nt;
+}
+
+long
+BitFab::collate (Vector<IntVect>& ar, long start) const noexcept
+{
+    BL_ASSERT(start >= 0);
+    long count = 0;
+    for (int k = 0; k < m_nz; ++k) {
+        for (int j = 0; j < m_ny; ++j) {
+            const Word* row = rowPtr(m_lo.y+j, m_lo.z+k);
+            for (int w = 0; w < m_nwords; ++w) {
+                for (Word v = row[w]; v != 0; v &= v-1) {
+                    const int i = m_lo.x + w*64 + ctz(v);
+                    ar[start+count] = IntVect(AMREX_D_DECL(i, m_lo.y+j, m_lo.z+k));
+                    ++count;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+}
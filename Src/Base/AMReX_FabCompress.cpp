@@ -0,0 +1,234 @@
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <AMReX_FabCompress.H>
+#include <AMReX.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_Utility.H>
+
+namespace amrex {
+
+namespace {
+
+    using UInt = std::conditional<sizeof(Real) == 8, std::uint64_t, std::uint32_t>::type;
+
+    enum : char { mode_lossless = 0, mode_quantized = 1 };
+
+    // Quantized values are limited so that the linear prediction cannot
+    // overflow and the rounding error of q*step stays far below step/2.
+    constexpr double max_quantized = 1.e12;
+
+    inline UInt to_bits (Real x) noexcept
+    {
+        UInt u;
+        std::memcpy(&u, &x, sizeof(Real));
+        return u;
+    }
+
+    inline Real from_bits (UInt u) noexcept
+    {
+        Real x;
+        std::memcpy(&x, &u, sizeof(Real));
+        return x;
+    }
+
+    inline int significant_bytes (UInt u) noexcept
+    {
+        int nb = 0;
+        while (u != 0) {
+            ++nb;
+            u >>= 8;
+        }
+        return nb;
+    }
+
+    void encode_lossless (const Real* data, std::size_t n, Vector<char>& out)
+    {
+        out.push_back(mode_lossless);
+
+        UInt prev = 0;
+        std::size_t i = 0;
+        while (i < n)
+        {
+            //
+            // Two values share one byte of byte counts.
+            //
+            UInt x[2] = {0, 0};
+            int nb[2] = {0, 0};
+            const int m = (i+1 < n) ? 2 : 1;
+            for (int k = 0; k < m; ++k) {
+                const UInt u = to_bits(data[i+k]);
+                x[k] = u ^ prev;
+                nb[k] = significant_bytes(x[k]);
+                prev = u;
+            }
+            out.push_back(static_cast<char>((nb[0] << 4) | nb[1]));
+            for (int k = 0; k < m; ++k) {
+                for (int b = 0; b < nb[k]; ++b) {
+                    out.push_back(static_cast<char>((x[k] >> (8*b)) & 0xff));
+                }
+            }
+            i += m;
+        }
+    }
+
+    void decode_lossless (const unsigned char* in, const unsigned char* end, Real* data, std::size_t n)
+    {
+        UInt prev = 0;
+        std::size_t i = 0;
+        while (i < n)
+        {
+            BL_ASSERT(in < end);
+            const int counts = *in++;
+            const int m = (i+1 < n) ? 2 : 1;
+            for (int k = 0; k < m; ++k) {
+                const int nb = (k == 0) ? (counts >> 4) : (counts & 0xf);
+                UInt x = 0;
+                for (int b = 0; b < nb; ++b) {
+                    x |= static_cast<UInt>(*in++) << (8*b);
+                }
+                prev ^= x;
+                data[i+k] = from_bits(prev);
+            }
+            i += m;
+        }
+        BL_ASSERT(in == end);
+        amrex::ignore_unused(end);
+    }
+
+    inline void put_varint (std::uint64_t z, Vector<char>& out)
+    {
+        while (z >= 0x80) {
+            out.push_back(static_cast<char>((z & 0x7f) | 0x80));
+            z >>= 7;
+        }
+        out.push_back(static_cast<char>(z));
+    }
+
+    inline std::uint64_t get_varint (const unsigned char*& in, const unsigned char* end)
+    {
+        std::uint64_t z = 0;
+        int shift = 0;
+        unsigned char c;
+        do {
+            BL_ASSERT(in < end);
+            c = *in++;
+            z |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+            shift += 7;
+        } while (c & 0x80);
+        amrex::ignore_unused(end);
+        return z;
+    }
+
+    bool encode_quantized (const Real* data, std::size_t n, Real tolerance, Vector<char>& out)
+    {
+        const std::size_t start = out.size();
+
+        // Slightly less than 2*tolerance leaves room for rounding in q*step.
+        const double step = 2.0*(1.0-1.e-3)*static_cast<double>(tolerance);
+        out.push_back(mode_quantized);
+        std::uint64_t sbits;
+        std::memcpy(&sbits, &step, sizeof(double));
+        for (int b = 0; b < 8; ++b) {   // little endian, like the lossless bytes
+            out.push_back(static_cast<char>((sbits >> (8*b)) & 0xff));
+        }
+
+        //
+        // A nonzero residual d is stored as 2*zigzag(d)-1 and a run of c
+        // zero residuals as 2*c, both with seven bits per byte.
+        //
+        std::int64_t q1 = 0, q2 = 0;
+        std::uint64_t nzero = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double r = static_cast<double>(data[i]) / step;
+            if (!(std::abs(r) < max_quantized)) {   // also catches NaN
+                out.resize(start);
+                return false;
+            }
+            const std::int64_t q = std::llround(r);
+            const std::int64_t d = q - (2*q1 - q2);
+            if (d == 0) {
+                ++nzero;
+            } else {
+                if (nzero > 0) {
+                    put_varint(2*nzero, out);
+                    nzero = 0;
+                }
+                const std::uint64_t z = (static_cast<std::uint64_t>(d) << 1) ^ static_cast<std::uint64_t>(d >> 63);
+                put_varint(2*z-1, out);
+            }
+            q2 = q1;
+            q1 = q;
+        }
+        if (nzero > 0) {
+            put_varint(2*nzero, out);
+        }
+        return true;
+    }
+
+    void decode_quantized (const unsigned char* in, const unsigned char* end, Real* data, std::size_t n)
+    {
+        BL_ASSERT(end - in >= 8);
+        std::uint64_t sbits = 0;
+        for (int b = 0; b < 8; ++b) {
+            sbits |= static_cast<std::uint64_t>(*in++) << (8*b);
+        }
+        double step;
+        std::memcpy(&step, &sbits, sizeof(double));
+
+        std::int64_t q1 = 0, q2 = 0;
+        std::size_t i = 0;
+        while (i < n)
+        {
+            const std::uint64_t t = get_varint(in, end);
+            std::int64_t d = 0;
+            std::uint64_t nvals = t/2;   // a run of zero residuals
+            if (t & 1) {
+                const std::uint64_t z = (t+1)/2;
+                d = static_cast<std::int64_t>(z >> 1) ^ -static_cast<std::int64_t>(z & 1);
+                nvals = 1;
+            }
+            BL_ASSERT(nvals > 0 && i + nvals <= n);
+            for (std::uint64_t m = 0; m < nvals; ++m) {
+                const std::int64_t q = d + (2*q1 - q2);
+                data[i++] = static_cast<Real>(static_cast<double>(q)*step);
+                q2 = q1;
+                q1 = q;
+            }
+        }
+        BL_ASSERT(in == end);
+        amrex::ignore_unused(end);
+    }
+}
+
+std::size_t
+FabCompress::Encode (const Real* data, std::size_t n, Real tolerance, Vector<char>& out)
+{
+    const std::size_t start = out.size();
+    if (tolerance <= 0.0 || !encode_quantized(data, n, tolerance, out)) {
+        encode_lossless(data, n, out);
+    }
+    return out.size() - start;
+}
+
+void
+FabCompress::Decode (const char* in, std::size_t nbytes, Real* data, std::size_t n)
+{
+    BL_ASSERT(nbytes > 0);
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(in);
+    const unsigned char* end = p + nbytes;
+    const char mode = static_cast<char>(*p++);
+    if (mode == mode_lossless) {
+        decode_lossless(p, end, data, n);
+    } else if (mode == mode_quantized) {
+        decode_quantized(p, end, data, n);
+    } else {
+        amrex::Abort("FabCompress::Decode: unknown encoding");
+    }
+}
+
+}
@@ -3,6 +3,7 @@
 #include <cstdlib>
 #include <limits>
 #include <cstring>
+#include <cstdint>
 
 #include <AMReX.H>
 #include <AMReX_FabConv.H>
@@ -904,6 +905,148 @@ operator>> (std::istream&   is,
     return is;
 }
 
+//
+// Fast paths for IEEE single and double precision in native or reversed
+// byte order, which is all that current machines write.  The byte swaps
+// and the precision conversions run in loops the compiler vectorizes,
+// instead of bit field by bit field in PD_fconvert.
+//
+
+namespace {
+
+template <int N> struct UIntOfSize;
+template <> struct UIntOfSize<4> { typedef std::uint32_t type; };
+template <> struct UIntOfSize<8> { typedef std::uint64_t type; };
+
+inline std::uint32_t
+byte_swap (std::uint32_t x)
+{
+    return ((x & 0x000000ffU) << 24) | ((x & 0x0000ff00U) <<  8)
+        |  ((x & 0x00ff0000U) >>  8) | ((x & 0xff000000U) >> 24);
+}
+
+inline std::uint64_t
+byte_swap (std::uint64_t x)
+{
+    return (std::uint64_t(byte_swap(std::uint32_t(x))) << 32)
+        |   std::uint64_t(byte_swap(std::uint32_t(x >> 32)));
+}
+
+//
+// The size in bytes of rd if it has the format of the native float or
+// double in native or reversed byte order, and 0 otherwise.  swap is set
+// if the bytes are reversed.
+//
+int
+ieee_size (const RealDescriptor& rd, bool& swap)
+{
+    const RealDescriptor* native;
+    if (rd.formatarray() == FPC::Native32RealDescriptor().formatarray()) {
+        native = &FPC::Native32RealDescriptor();
+    } else if (rd.formatarray() == FPC::Native64RealDescriptor().formatarray()) {
+        native = &FPC::Native64RealDescriptor();
+    } else {
+        return 0;
+    }
+
+    const Vector<int>& ord  = rd.orderarray();
+    const Vector<int>& nord = native->orderarray();
+    const int n = nord.size();
+    if (ord.size() != n) {
+        return 0;
+    }
+    swap = (ord != nord);
+    for (int i = 0; swap && i < n; ++i) {
+        if (ord[i] != nord[n-1-i]) {
+            return 0;
+        }
+    }
+    return n;
+}
+
+template <typename T>
+void
+ieee_swap (void* out, const void* in, long nitems)
+{
+    typedef typename UIntOfSize<sizeof(T)>::type U;
+
+    const char* pin  = static_cast<const char*>(in);
+    char*       pout = static_cast<char*>(out);
+
+    AMREX_PRAGMA_SIMD
+    for (long i = 0; i < nitems; ++i) {
+        U u;
+        std::memcpy(&u, pin + i*sizeof(U), sizeof(U));
+        u = byte_swap(u);
+        std::memcpy(pout + i*sizeof(U), &u, sizeof(U));
+    }
+}
+
+template <typename TIN, typename TOUT, bool SWAPIN, bool SWAPOUT>
+void
+ieee_convert (void* out, const void* in, long nitems)
+{
+    typedef typename UIntOfSize<sizeof(TIN)>::type  UIN;
+    typedef typename UIntOfSize<sizeof(TOUT)>::type UOUT;
+
+    const char* pin  = static_cast<const char*>(in);
+    char*       pout = static_cast<char*>(out);
+
+    AMREX_PRAGMA_SIMD
+    for (long i = 0; i < nitems; ++i) {
+        UIN ui;
+        std::memcpy(&ui, pin + i*sizeof(UIN), sizeof(UIN));
+        if (SWAPIN) ui = byte_swap(ui);
+        TIN xi;
+        std::memcpy(&xi, &ui, sizeof(UIN));
+        const TOUT xo = static_cast<TOUT>(xi);
+        UOUT uo;
+        std::memcpy(&uo, &xo, sizeof(UOUT));
+        if (SWAPOUT) uo = byte_swap(uo);
+        std::memcpy(pout + i*sizeof(UOUT), &uo, sizeof(UOUT));
+    }
+}
+
+template <typename TIN, typename TOUT>
+void
+ieee_convert (void* out, const void* in, long nitems, bool swapin, bool swapout)
+{
+    if (swapin) {
+        if (swapout) {
+            ieee_convert<TIN,TOUT,true,true>(out, in, nitems);
+        } else {
+            ieee_convert<TIN,TOUT,true,false>(out, in, nitems);
+        }
+    } else {
+        if (swapout) {
+            ieee_convert<TIN,TOUT,false,true>(out, in, nitems);
+        } else {
+            ieee_convert<TIN,TOUT,false,false>(out, in, nitems);
+        }
+    }
+}
+
+void
+ieee_convert (void* out, const void* in, long nitems,
+              int osize, bool oswap, int isize, bool iswap)
+{
+    if (osize == isize) {
+        if (oswap == iswap) {
+            std::memcpy(out, in, nitems*osize);
+        } else if (osize == sizeof(float)) {
+            ieee_swap<float>(out, in, nitems);
+        } else {
+            ieee_swap<double>(out, in, nitems);
+        }
+    } else if (isize == sizeof(double)) {
+        ieee_convert<double,float>(out, in, nitems, iswap, oswap);
+    } else {
+        ieee_convert<float,double>(out, in, nitems, iswap, oswap);
+    }
+}
+
+}
+
 static
 void
 PD_convert (void*                 out,
@@ -916,29 +1059,23 @@ PD_convert (void*                 out,
             int                   onescmp = 0)
 {
     BL_PROFILE("PD_convert");
+    bool oswap(false), iswap(false);
+    const int osize(boffs == 0 && ! onescmp ? ieee_size(ord, oswap) : 0);
+    const int isize(osize > 0 ? ieee_size(ird, iswap) : 0);
     if (ord == ird && boffs == 0)
     {
         size_t n = size_t(nitems);
         BL_ASSERT(int(n) == nitems);
         memcpy(out, in, n*ord.numBytes());
     }
+    else if (osize > 0 && isize > 0)
+    {
+        ieee_convert(out, in, nitems, osize, oswap, isize, iswap);
+    }
     else if (ord.formatarray() == ird.formatarray() && boffs == 0 && ! onescmp) {
         permute_real_word_order(out, in, nitems,
                                 ord.order(), ird.order(), ord.numBytes());
     }
-    else if (ird == FPC::NativeRealDescriptor() && ord == FPC::Native32RealDescriptor()) {
-      auto rIn = static_cast<const char*>(in);
-      auto rOut= static_cast<char*>(out);
-      for(long i(0); i < nitems; ++i) {
-        Real x;
-        float y;
-        std::memcpy(&x, rIn, sizeof(Real));
-        y = x;
-        std::memcpy(rOut, &y, sizeof(float));
-        rOut += sizeof(float);
-        rIn += sizeof(Real);
-      }
-    }
     else
     {
         PD_fconvert(out, in, nitems, boffs, ord.format(), ord.order(),
@@ -0,0 +1,184 @@
+
+#include <algorithm>
+
+#include <AMReX_FabFactory.H>
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+
+namespace amrex {
+
+namespace {
+    bool initialized = false;
+    bool recycle_enabled = false;
+    int  recycle_steps = 0;
+    long recycle_max_bytes = 1024L*1024L*1024L;
+
+    //
+    // FABs store a pointer to their arena, so the recycler must outlive
+    // anything allocated through it.  It is therefore never destroyed;
+    // after Finalize it simply forwards frees to the arena each buffer
+    // came from.
+    //
+    FabRecycler& the_fab_recycler ()
+    {
+        static FabRecycler r;
+        return r;
+    }
+}
+
+void
+FabRecycler::Initialize ()
+{
+    if (initialized) return;
+    initialized = true;
+
+    ParmParse pp("amrex");
+    pp.query("fab_recycle_steps", recycle_steps);
+    pp.query("fab_recycle_max_bytes", recycle_max_bytes);
+
+    recycle_enabled = recycle_steps > 0;
+
+    amrex::ExecOnFinalize(FabRecycler::Finalize);
+}
+
+void
+FabRecycler::Finalize ()
+{
+    if (recycle_enabled)
+    {
+        if (amrex::Verbose() > 0) {
+            the_fab_recycler().PrintStats();
+        }
+        the_fab_recycler().release();
+    }
+    recycle_enabled = false;
+    initialized = false;
+}
+
+FabRecycler*
+FabRecycler::Get () noexcept
+{
+    return recycle_enabled ? &the_fab_recycler() : nullptr;
+}
+
+void
+FabRecycler::NextStep ()
+{
+    if (recycle_enabled)
+    {
+        FabRecycler& r = the_fab_recycler();
+        std::lock_guard<std::mutex> lock(r.m_mutex);
+        ++r.m_step;
+        r.release_older_than(r.m_step - recycle_steps);
+    }
+}
+
+void*
+FabRecycler::alloc (std::size_t nbytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    void* p = nullptr;
+    Arena* owner = nullptr;
+
+    auto it = m_kept.find(nbytes);
+    if (it != m_kept.end() && !it->second.empty())
+    {
+        //
+        // Hand back the most recently freed buffer; it is the most likely
+        // to still be in cache.
+        //
+        p = it->second.back().p;
+        owner = it->second.back().owner;
+        it->second.pop_back();
+        if (it->second.empty()) m_kept.erase(it);
+        m_bytes_kept -= nbytes;
+        ++m_hits;
+    }
+    else
+    {
+        owner = The_Arena();
+        p = owner->alloc(nbytes);
+        ++m_misses;
+    }
+
+    m_live[p] = Live{nbytes, owner};
+
+    return p;
+}
+
+void
+FabRecycler::free (void* p)
+{
+    if (p == nullptr) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_live.find(p);
+    BL_ASSERT(it != m_live.end());
+    const std::size_t nbytes = it->second.nbytes;
+    Arena* owner = it->second.owner;
+    m_live.erase(it);
+
+    if (recycle_enabled && (recycle_max_bytes <= 0 ||
+                            m_bytes_kept + nbytes <= static_cast<std::size_t>(recycle_max_bytes)))
+    {
+        m_kept[nbytes].push_back(Entry{p, owner, m_step});
+        m_bytes_kept += nbytes;
+    }
+    else
+    {
+        owner->free(p);
+    }
+}
+
+void
+FabRecycler::release ()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    release_older_than(m_step+1);
+}
+
+void
+FabRecycler::release_older_than (long step)
+{
+    for (auto it = m_kept.begin(); it != m_kept.end(); )
+    {
+        auto& v = it->second;
+        std::size_t n = 0;
+        while (n < v.size() && v[n].step < step) {
+            v[n].owner->free(v[n].p);
+            ++n;
+        }
+        if (n > 0) {
+            v.erase(v.begin(), v.begin()+n);
+            m_bytes_kept -= n * it->first;
+            m_released += n;
+        }
+        if (v.empty()) {
+            it = m_kept.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void
+FabRecycler::PrintStats () const
+{
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+
+    long counts[3] = { m_hits, m_misses, m_released };
+    ParallelDescriptor::ReduceLongSum(counts, 3, IOProc);
+
+    long max_megabytes = m_bytes_kept / (1024*1024);
+    ParallelDescriptor::ReduceLongMax(max_megabytes, IOProc);
+
+    const long n = std::max(counts[0]+counts[1], 1L);
+    amrex::Print() << "FabRecycler: " << counts[0] << " hits, " << counts[1] << " misses ("
+                   << (100*counts[0])/n << "% hit rate), " << counts[2] << " buffers released, "
+                   << max_megabytes << " MB still kept on the largest rank\n";
+}
+
+}
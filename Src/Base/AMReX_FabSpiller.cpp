@@ -0,0 +1,332 @@
+
+#include <deque>
+#include <thread>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <functional>
+#include <atomic>
+#include <condition_variable>
+
+#include <AMReX_FabSpiller.H>
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+namespace amrex {
+
+namespace {
+
+    bool initialized = false;
+    std::string spill_dir;
+    int spill_nthreads = 2;
+    std::atomic<int> spiller_count(0);
+
+    //
+    // The background I/O threads are shared by all spillers.  Reads are
+    // put at the front of the queue because someone is about to wait on them.
+    //
+    std::vector<std::thread> workers;
+    std::deque<std::packaged_task<void()> > tasks;
+    std::mutex pool_mutex;
+    std::condition_variable pool_cv;
+    bool stopping = false;
+
+    void worker_loop ()
+    {
+        for (;;)
+        {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(pool_mutex);
+                pool_cv.wait(lock, [] { return stopping || !tasks.empty(); });
+                if (tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::future<void> submit (std::function<void()> f, bool urgent)
+    {
+        std::packaged_task<void()> task(std::move(f));
+        std::future<void> fut = task.get_future();
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            if (workers.empty()) {
+                stopping = false;
+                for (int i = 0; i < spill_nthreads; ++i) {
+                    workers.emplace_back(worker_loop);
+                }
+            }
+            if (urgent) {
+                tasks.push_front(std::move(task));
+            } else {
+                tasks.push_back(std::move(task));
+            }
+        }
+        pool_cv.notify_one();
+        return fut;
+    }
+}
+
+void
+FabSpiller::Initialize ()
+{
+    if (initialized) return;
+    initialized = true;
+
+    const char* tmpdir = std::getenv("TMPDIR");
+    spill_dir = (tmpdir != nullptr && *tmpdir != '\0') ? tmpdir : "/tmp";
+
+    ParmParse pp("amrex");
+    pp.query("spill_dir", spill_dir);
+    pp.query("spill_nthreads", spill_nthreads);
+    spill_nthreads = std::max(spill_nthreads, 1);
+
+    amrex::ExecOnFinalize(FabSpiller::Finalize);
+}
+
+void
+FabSpiller::Finalize ()
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        stopping = true;
+    }
+    pool_cv.notify_all();
+    for (auto& t : workers) {
+        t.join();
+    }
+    workers.clear();
+    initialized = false;
+}
+
+FabSpiller::FabSpiller (FabArray<FArrayBox>& fa, const std::string& name)
+    : m_fa(fa),
+      m_name(name),
+      m_id(spiller_count++),
+      m_slot(fa.local_size())
+{
+    BL_ASSERT(initialized);
+}
+
+FabSpiller::~FabSpiller ()
+{
+    restore();
+    for (int li = 0; li < static_cast<int>(m_slot.size()); ++li) {
+        std::remove(fileName(li).c_str());
+    }
+}
+
+std::string
+FabSpiller::fileName (int li) const
+{
+    return spill_dir + "/amrex_spill_" + m_name + "_" + std::to_string(m_id) + "_"
+        + std::to_string(ParallelDescriptor::MyProc()) + "_"
+        + std::to_string(m_fa.IndexArray()[li]);
+}
+
+void
+FabSpiller::finish (int li, bool wait)
+{
+    Slot& s = m_slot[li];
+    if (s.state != State::Writing && s.state != State::Reading) return;
+
+    if (!wait && s.pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+
+    const double strt_time = amrex::second();
+    try {
+        s.pending.get();
+    } catch (std::exception const& e) {
+        amrex::Abort(std::string("FabSpiller: ") + e.what());
+    }
+    m_wait_time += amrex::second() - strt_time;
+
+    // The write task has freed the FAB unless a prefetch asked to keep it.
+    if (s.state == State::Writing && s.released) {
+        s.state = State::OnDisk;
+    } else {
+        s.state = State::Resident;
+    }
+    s.keep = false;
+    s.released = false;
+}
+
+void
+FabSpiller::poll ()
+{
+    for (int li = 0; li < static_cast<int>(m_slot.size()); ++li) {
+        finish(li, false);
+    }
+}
+
+void
+FabSpiller::spill ()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    poll();
+    for (int li = 0; li < static_cast<int>(m_slot.size()); ++li) {
+        spillOne(li);
+    }
+}
+
+void
+FabSpiller::spillLocal (int li)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    poll();
+    spillOne(li);
+}
+
+void
+FabSpiller::spillOne (int li)
+{
+    Slot& s = m_slot[li];
+    if (s.state == State::Reading) {
+        finish(li, true);
+    }
+    if (s.state == State::Writing && s.keep) {
+        // The write will keep the data, so let it finish and write again.
+        finish(li, true);
+    }
+    if (s.state == State::Resident)
+    {
+        const int gi = m_fa.IndexArray()[li];
+        const FArrayBox& fab = m_fa.get(gi);
+        const char* p = reinterpret_cast<const char*>(fab.dataPtr());
+        const std::size_t nbytes = fab.nBytes();
+        const std::string fname = fileName(li);
+        s.pending = submit([this, li, gi, p, nbytes, fname] () {
+                {
+                    std::ofstream ofs(fname, std::ios::out | std::ios::binary | std::ios::trunc);
+                    ofs.write(p, nbytes);
+                    if (!ofs.good()) throw std::runtime_error("cannot write " + fname);
+                }
+                // Free the memory as soon as the data are on disk.
+                std::lock_guard<std::mutex> lock(m_slot_mutex);
+                if (!m_slot[li].keep) {
+                    m_fa.get(gi).clear();
+                    m_slot[li].released = true;
+                }
+            }, false);
+        s.state = State::Writing;
+        m_bytes_written += nbytes;
+    }
+}
+
+void
+FabSpiller::prefetchLocal (int li)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Slot& s = m_slot[li];
+    if (s.state == State::Writing)
+    {
+        {
+            std::lock_guard<std::mutex> slot_lock(m_slot_mutex);
+            if (!s.released) {
+                s.keep = true;
+                return;
+            }
+        }
+        // The data are already on disk and freed; read them back.
+        finish(li, true);
+    }
+    if (s.state == State::OnDisk)
+    {
+        FArrayBox& fab = m_fa.get(m_fa.IndexArray()[li]);
+        // The BaseFab version does not initialize the data we are about to read.
+        static_cast<BaseFab<Real>&>(fab).resize(fab.box(), fab.nComp());
+        char* p = reinterpret_cast<char*>(fab.dataPtr());
+        const std::size_t nbytes = fab.nBytes();
+        const std::string fname = fileName(li);
+        s.pending = submit([=] () {
+                std::ifstream ifs(fname, std::ios::in | std::ios::binary);
+                ifs.read(p, nbytes);
+                if (!ifs.good()) throw std::runtime_error("cannot read " + fname);
+            }, true);
+        s.state = State::Reading;
+        m_bytes_read += nbytes;
+    }
+}
+
+void
+FabSpiller::prefetchAhead (const MFIter& mfi, int depth)
+{
+    const int li = mfi.LocalIndex();
+    const int n = static_cast<int>(m_slot.size());
+    for (int d = 1; d <= depth && li+d < n; ++d) {
+        prefetchLocal(li+d);
+    }
+}
+
+void
+FabSpiller::restoreLocal (int li)
+{
+    prefetchLocal(li);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    finish(li, true);
+}
+
+FArrayBox&
+FabSpiller::get (const MFIter& mfi)
+{
+    restoreLocal(mfi.LocalIndex());
+    return m_fa[mfi];
+}
+
+void
+FabSpiller::restore ()
+{
+    for (int li = 0; li < static_cast<int>(m_slot.size()); ++li) {
+        prefetchLocal(li);
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int li = 0; li < static_cast<int>(m_slot.size()); ++li) {
+        finish(li, true);
+    }
+}
+
+void
+FabSpiller::finishSpills ()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int li = 0; li < static_cast<int>(m_slot.size()); ++li) {
+        if (m_slot[li].state == State::Writing) finish(li, true);
+    }
+}
+
+bool
+FabSpiller::isResident (int li) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_slot[li].state == State::Resident;
+}
+
+void
+FabSpiller::PrintStats () const
+{
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+
+    long bytes[2];
+    Real wait_time;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        bytes[0] = m_bytes_written;
+        bytes[1] = m_bytes_read;
+        wait_time = m_wait_time;
+    }
+    ParallelDescriptor::ReduceLongSum(bytes, 2, IOProc);
+    ParallelDescriptor::ReduceRealMax(wait_time, IOProc);
+
+    amrex::Print() << "FabSpiller " << m_name << ": " << bytes[0]/(1024*1024) << " MB written, "
+                   << bytes[1]/(1024*1024) << " MB read, max time waiting on I/O "
+                   << wait_time << " s\n";
+}
+
+}
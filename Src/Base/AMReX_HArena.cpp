@@ -0,0 +1,232 @@
+
+#include <fstream>
+#include <cstdint>
+#include <sstream>
+#include <algorithm>
+
+#include <AMReX_HArena.H>
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace amrex {
+
+namespace {
+
+#if defined(__linux__)
+    // From <numaif.h>.  We call the system call directly so that we do not
+    // need to link with libnuma.
+    constexpr int amrex_mpol_bind = 2;
+    constexpr int amrex_mpol_interleave = 3;
+
+    bool numa_warning_printed = false;
+
+    void* map_aligned (std::size_t len, std::size_t alignment)
+    {
+        void* p = mmap(nullptr, len+alignment, PROT_READ|PROT_WRITE,
+                       MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return nullptr;
+        //
+        // Trim the mapping so that it starts on a huge page boundary.
+        //
+        char* cp = static_cast<char*>(p);
+        std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(cp);
+        std::size_t head = (alignment - addr % alignment) % alignment;
+        std::size_t tail = alignment - head;
+        if (head > 0) munmap(cp, head);
+        if (tail > 0) munmap(cp+head+len, tail);
+        return cp+head;
+    }
+#endif
+
+}
+
+HArena::HArena (std::size_t hunk_size, bool use_hugetlb, NumaPolicy numa_policy, int numa_node)
+    : CArena(((std::max(hunk_size,std::size_t(1))+HugePageSize-1)/HugePageSize)*HugePageSize),
+      m_use_hugetlb(use_hugetlb),
+      m_numa_policy(numa_policy),
+      m_numa_node(numa_node)
+{
+}
+
+HArena::~HArena ()
+{
+    //
+    // CArena's destructor would call its own deallocate_system on our
+    // mappings, so we unmap the hunks here.
+    //
+    for (auto const& a : m_alloc) {
+        deallocate_system(a.first, a.second);
+    }
+    m_alloc.clear();
+}
+
+HArena::NumaPolicy
+HArena::numaPolicy (const std::string& s)
+{
+    if (s == "bind") {
+        return NumaPolicy::bind;
+    } else if (s == "interleave") {
+        return NumaPolicy::interleave;
+    } else if (s == "none" || s.empty()) {
+        return NumaPolicy::none;
+    } else {
+        amrex::Abort("HArena: unknown NUMA policy " + s);
+        return NumaPolicy::none;
+    }
+}
+
+void*
+HArena::allocate_system (std::size_t nbytes)
+{
+#if defined(__linux__)
+    const std::size_t len = ((nbytes+HugePageSize-1)/HugePageSize)*HugePageSize;
+
+    void* p = nullptr;
+    bool hugetlb = false;
+
+    if (m_use_hugetlb) {
+        p = mmap(nullptr, len, PROT_READ|PROT_WRITE,
+                 MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+        if (p == MAP_FAILED) {
+            p = nullptr;
+        } else {
+            hugetlb = true;
+        }
+    }
+
+    if (p == nullptr) {
+        p = map_aligned(len, HugePageSize);
+        if (p == nullptr) amrex::Abort("HArena: mmap failed");
+#ifdef MADV_HUGEPAGE
+        madvise(p, len, MADV_HUGEPAGE);
+#endif
+    }
+
+    if (m_numa_policy != NumaPolicy::none)
+    {
+        //
+        // This has to happen before the memory is first touched.
+        //
+        unsigned long nodemask[4] = {0,0,0,0};
+        const unsigned long maxnode = sizeof(nodemask)*8;
+        int mode;
+        if (m_numa_policy == NumaPolicy::bind) {
+            mode = amrex_mpol_bind;
+            const int node = std::max(0,std::min(m_numa_node, static_cast<int>(maxnode)-1));
+            nodemask[node/(sizeof(unsigned long)*8)] = 1UL << (node%(sizeof(unsigned long)*8));
+        } else {
+            mode = amrex_mpol_interleave;
+            std::fill(nodemask, nodemask+4, ~0UL);
+        }
+        long r = syscall(SYS_mbind, p, len, mode, nodemask, maxnode, 0);
+        if (r != 0 && !numa_warning_printed) {
+            numa_warning_printed = true;
+            amrex::Warning("HArena: mbind failed; memory is not NUMA bound");
+        }
+    }
+
+    if (hugetlb) {
+        m_hugetlb_bytes += len;
+        m_hugetlb_hunks.push_back(p);
+    }
+
+    return p;
+#else
+    return Arena::allocate_system(nbytes);
+#endif
+}
+
+void
+HArena::deallocate_system (void* p, std::size_t nbytes)
+{
+#if defined(__linux__)
+    const std::size_t len = ((nbytes+HugePageSize-1)/HugePageSize)*HugePageSize;
+    auto it = std::find(m_hugetlb_hunks.begin(), m_hugetlb_hunks.end(), p);
+    if (it != m_hugetlb_hunks.end()) {
+        m_hugetlb_hunks.erase(it);
+        m_hugetlb_bytes -= len;
+    }
+    munmap(p, len);
+#else
+    Arena::deallocate_system(p, nbytes);
+#endif
+}
+
+double
+HArena::hugePageCoverage () const
+{
+    std::size_t total = 0;
+    for (auto const& a : m_alloc) {
+        total += ((a.second+HugePageSize-1)/HugePageSize)*HugePageSize;
+    }
+    if (total == 0) return 0.0;
+
+    std::size_t huge = m_hugetlb_bytes;
+
+#if defined(__linux__)
+    //
+    // Transparent huge pages are reported per mapping as AnonHugePages.
+    // A mapping may have been merged with a neighbor, in which case we
+    // attribute its huge pages in proportion to the overlap.
+    //
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    std::uintptr_t vma_lo = 0, vma_hi = 0;
+    std::size_t overlap = 0;
+    while (std::getline(smaps, line))
+    {
+        std::istringstream is(line);
+        std::string range;
+        is >> range;
+        if (range.empty()) continue;
+        auto dash = range.find('-');
+        if (dash != std::string::npos && range.back() != ':')
+        {
+            vma_lo = std::stoull(range.substr(0,dash), nullptr, 16);
+            vma_hi = std::stoull(range.substr(dash+1), nullptr, 16);
+            overlap = 0;
+            for (auto const& a : m_alloc) {
+                if (std::find(m_hugetlb_hunks.begin(), m_hugetlb_hunks.end(), a.first)
+                    != m_hugetlb_hunks.end()) continue;
+                std::uintptr_t lo = reinterpret_cast<std::uintptr_t>(a.first);
+                std::uintptr_t hi = lo + ((a.second+HugePageSize-1)/HugePageSize)*HugePageSize;
+                std::uintptr_t olo = std::max(lo,vma_lo), ohi = std::min(hi,vma_hi);
+                if (ohi > olo) overlap += ohi - olo;
+            }
+        }
+        else if (overlap > 0 && line.compare(0,14,"AnonHugePages:") == 0)
+        {
+            std::istringstream is(line.substr(14));
+            std::size_t kb = 0;
+            is >> kb;
+            const double frac = double(overlap) / double(vma_hi-vma_lo);
+            huge += static_cast<std::size_t>(frac * kb * 1024);
+        }
+    }
+#endif
+
+    return std::min(1.0, double(huge)/double(total));
+}
+
+void
+HArena::PrintStats (const std::string& name) const
+{
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+
+    Real min_coverage = hugePageCoverage();
+    Real max_coverage = min_coverage;
+    ParallelDescriptor::ReduceRealMin(min_coverage, IOProc);
+    ParallelDescriptor::ReduceRealMax(max_coverage, IOProc);
+
+    amrex::Print() << "[" << name << "] huge page coverage spread across MPI: ["
+                   << Real(100.0)*min_coverage << "% ... " << Real(100.0)*max_coverage << "%]\n";
+}
+
+}
@@ -12,6 +12,7 @@
 #include <AMReX_BLProfiler.H>
 #include <AMReX_iMultiFab.H>
 #include <AMReX_FabArrayUtility.H>
+#include <AMReX_TileSizeTuner.H>
 
 #ifdef AMREX_MEM_PROFILING
 #include <AMReX_MemProfiler.H>
@@ -372,10 +373,12 @@ MultiFab::LinComb (MultiFab& dst,
 
     BL_PROFILE("MultiFab::LinComb()");
 
+    TileSizeTuner tuner("MultiFab::LinComb", dst);
+
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-    for (MFIter mfi(dst,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    for (MFIter mfi(dst,tuner.info()); mfi.isValid(); ++mfi)
     {
         const Box& bx = mfi.growntilebox(nghost);
 	
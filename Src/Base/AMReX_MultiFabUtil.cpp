@@ -260,30 +260,25 @@ namespace amrex
         BoxArray crse_S_fine_BA = fine_BA;
 	crse_S_fine_BA.coarsen(ratio);
 
-        MultiFab crse_S_fine(crse_S_fine_BA,fine_dm,ncomp,0,MFInfo(),FArrayBoxFactory());
-
 	MultiFab fvolume;
 	fgeom.GetVolume(fvolume, fine_BA, fine_dm, 0);
 
-#ifdef _OPENMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-        for (MFIter mfi(crse_S_fine,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        //
+        // The averages go straight into S_crse or the send buffers.
+        //
+        S_crse.ParallelCopyFromKernel(crse_S_fine_BA, fine_dm, scomp, ncomp,
+                                      IntVect::TheZeroVector(), IntVect::TheZeroVector(),
+        [&] (Box const& bx, Array4<Real> const& crsearr, int fi)
         {
-            //  NOTE: The tilebox is defined at the coarse level.
-            const Box& bx = mfi.tilebox();
-            Array4<Real> const& crsearr = crse_S_fine.array(mfi);
-            Array4<Real const> const& finearr = S_fine.const_array(mfi);
-            Array4<Real const> const& finevolarr = fvolume.const_array(mfi);
+            Array4<Real const> const& finearr = S_fine.const_array(fi);
+            Array4<Real const> const& finevolarr = fvolume.const_array(fi);
 
             AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
             {
                 amrex_avgdown_with_vol(tbx,crsearr,finearr,finevolarr,
                                        0,scomp,ncomp,ratio);
             });
-	}
-
-        S_crse.copy(crse_S_fine,0,scomp,ncomp);
+        });
 #endif
    }
 
@@ -377,21 +372,17 @@ namespace amrex
         }
         else
         {
-            MultiFab crse_S_fine(crse_S_fine_BA, S_fine.DistributionMap(), ncomp, 0, MFInfo(), FArrayBoxFactory());
-
-#ifdef _OPENMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-            for (MFIter mfi(crse_S_fine,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            //
+            // The averages go straight into S_crse or the send buffers.
+            //
+            S_crse.ParallelCopyFromKernel(crse_S_fine_BA, S_fine.DistributionMap(), scomp, ncomp,
+                                          IntVect::TheZeroVector(), IntVect::TheZeroVector(),
+            [&] (Box const& bx, Array4<Real> const& crsearr, int fi)
             {
-                //  NOTE: The tilebox is defined at the coarse level.
-                const Box& bx = mfi.tilebox();
-                Array4<Real> const& crsearr = crse_S_fine.array(mfi);
-                Array4<Real const> const& finearr = S_fine.const_array(mfi);
+                Array4<Real const> const& finearr = S_fine.const_array(fi);
 
-                //  NOTE: We copy from component scomp of the fine fab into component 0 of the crse fab
-                //        because the crse fab is a temporary which was made starting at comp 0, it is
-                //        not part of the actual crse multifab which came in.
+                //  NOTE: crsearr starts at component scomp of S_crse, or is a send buffer
+                //        starting at component 0, so we write its component 0.
 
                 if (is_cell_centered) {
                     AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
@@ -404,9 +395,7 @@ namespace amrex
                         amrex_avgdown_nodes(tbx,crsearr,finearr,0,scomp,ncomp,ratio);
                     });
                 }
-            }
-
-            S_crse.copy(crse_S_fine,0,scomp,ncomp);
+            });
         }
    }
 
@@ -482,10 +471,17 @@ namespace amrex
         }
         else
         {
-            MultiFab ctmp(amrex::coarsen(fine.boxArray(),ratio), fine.DistributionMap(),
-                          ncomp, ngcrse, MFInfo(), FArrayBoxFactory());
-            average_down_faces(fine, ctmp, ratio, ngcrse);
-            crse.ParallelCopy(ctmp,0,0,ncomp,ngcrse,ngcrse);
+            crse.ParallelCopyFromKernel(amrex::coarsen(fine.boxArray(),ratio), fine.DistributionMap(),
+                                        0, ncomp, IntVect(ngcrse), IntVect(ngcrse),
+            [&] (Box const& bx, Array4<Real> const& crsearr, int fi)
+            {
+                Array4<Real const> const& finearr = fine.const_array(fi);
+
+                AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+                {
+                    amrex_avgdown_faces(tbx, crsearr, finearr, 0, 0, ncomp, ratio, dir);
+                });
+            });
         }
     }
 
@@ -545,10 +541,17 @@ namespace amrex
         }
         else
         {
-            MultiFab ctmp(amrex::coarsen(fine.boxArray(),ratio), fine.DistributionMap(),
-                          ncomp, ngcrse, MFInfo(), FArrayBoxFactory());
-            average_down_edges(fine, ctmp, ratio, ngcrse);
-            crse.ParallelCopy(ctmp,0,0,ncomp,ngcrse,ngcrse);
+            crse.ParallelCopyFromKernel(amrex::coarsen(fine.boxArray(),ratio), fine.DistributionMap(),
+                                        0, ncomp, IntVect(ngcrse), IntVect(ngcrse),
+            [&] (Box const& bx, Array4<Real> const& crsearr, int fi)
+            {
+                Array4<Real const> const& finearr = fine.const_array(fi);
+
+                AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+                {
+                    amrex_avgdown_edges(tbx, crsearr, finearr, 0, 0, ncomp, ratio, dir);
+                });
+            });
         }
     }
 
@@ -581,10 +584,17 @@ namespace amrex
         }
         else
         {
-            MultiFab ctmp(amrex::coarsen(fine.boxArray(),ratio), fine.DistributionMap(),
-                          ncomp, ngcrse, MFInfo(), FArrayBoxFactory());
-            average_down_nodal(fine, ctmp, ratio, ngcrse);
-            crse.ParallelCopy(ctmp,0,0,ncomp,ngcrse,ngcrse);
+            crse.ParallelCopyFromKernel(amrex::coarsen(fine.boxArray(),ratio), fine.DistributionMap(),
+                                        0, ncomp, IntVect(ngcrse), IntVect(ngcrse),
+            [&] (Box const& bx, Array4<Real> const& crsearr, int fi)
+            {
+                Array4<Real const> const& finearr = fine.const_array(fi);
+
+                AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+                {
+                    amrex_avgdown_nodes(tbx,crsearr,finearr,0,0,ncomp,ratio);
+                });
+            });
         }
     }
 
@@ -726,6 +736,43 @@ namespace amrex
         return mask;
     }
 
+    LayoutData<BitFab> makeFineBitMask (const BoxArray& cba, const DistributionMapping& cdm,
+                                        const BoxArray& fba, const IntVect& ratio)
+    {
+        return makeFineBitMask(cba, cdm, IntVect{0}, fba, ratio, Periodicity::NonPeriodic());
+    }
+
+    LayoutData<BitFab> makeFineBitMask (const BoxArray& cba, const DistributionMapping& cdm,
+                                        const IntVect& cnghost, const BoxArray& fba,
+                                        const IntVect& ratio, Periodicity const& period)
+    {
+        LayoutData<BitFab> mask(cba, cdm);
+
+        const BoxArray& cfba = amrex::coarsen(fba,ratio);
+        const std::vector<IntVect>& pshifts = period.shiftIntVect();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            std::vector <std::pair<int,Box> > isects;
+            for (MFIter mfi(mask); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = amrex::grow(mfi.validbox(),cnghost);
+                BitFab& bits = mask[mfi];
+                bits.define(bx);
+
+                for (const auto& iv : pshifts) {
+                    cfba.intersections(bx+iv, isects);
+                    for (const auto& is : isects) {
+                        bits.setVal(true, is.second-iv);
+                    }
+                }
+            }
+        }
+
+        return mask;
+    }
+
     void computeDivergence (MultiFab& divu, const Array<MultiFab const*,AMREX_SPACEDIM>& umac,
                             const Geometry& geom)
     {
@@ -1,12 +1,22 @@
 
 #include <AMReX_Utility.H>
 #include <AMReX_NFiles.H>
+#include <AMReX_ParallelReduce.H>
+#include <cstring>
 #include <deque>
+#include <limits>
+#include <memory>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace amrex {
 
 int NFilesIter::currentDeciderIndex(-1);
 int NFilesIter::minDigits(5);
+long NFilesIter::aggregatorChunkSize(64L * 1024L * 1024L);
 
 
 NFilesIter::NFilesIter(int noutfiles, const std::string &fileprefix,
@@ -493,6 +503,137 @@ NFilesIter &NFilesIter::operator++() {
 }
 
 
+void NFilesIter::WriteAggregated(const char *data, long nbytes, int aggregatorRanks)
+{
+  BL_PROFILE("NFilesIter::WriteAggregated()");
+  BL_ASSERT(useStaticSetSelection && ! useSparseFPP && ! isReading);
+  BL_ASSERT(aggregatorChunkSize > 0);
+
+#if defined(BL_USE_MPI) && (defined(__linux__) || defined(__APPLE__))
+
+  MPI_Comm comm(ParallelDescriptor::Communicator());
+  const int tag(ParallelDescriptor::SeqNum());
+
+  // ---- where each rank's data go, as with static set selection
+  Vector<long> allBytes(nProcs, 0);
+  ParallelAllGather::AllGather(nbytes, allBytes.dataPtr(), comm);
+  Vector<long> fileOffset(nProcs, 0), fileSize(nOutFiles, 0);
+  Vector<int> lastRank(nOutFiles, -1);
+  for(int i(0); i < nProcs; ++i) {
+    int fn(FileNumber(nOutFiles, i, groupSets));
+    fileOffset[i] = fileSize[fn];
+    fileSize[fn] += allBytes[i];
+    lastRank[fn] = i;
+  }
+
+  // ---- the ranks on this node that write to this file
+  MPI_Comm nodeComm, fileComm, aggComm;
+  BL_MPI_REQUIRE( MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, myProc,
+                                      MPI_INFO_NULL, &nodeComm) );
+  BL_MPI_REQUIRE( MPI_Comm_split(nodeComm, fileNumber, myProc, &fileComm) );
+  int fileCommRank(0);
+  BL_MPI_REQUIRE( MPI_Comm_rank(fileComm, &fileCommRank) );
+  int aggGroup(aggregatorRanks > 0 ? fileCommRank / aggregatorRanks : 0);
+  BL_MPI_REQUIRE( MPI_Comm_split(fileComm, aggGroup, myProc, &aggComm) );
+  int aggRank(0), aggSize(0);
+  BL_MPI_REQUIRE( MPI_Comm_rank(aggComm, &aggRank) );
+  BL_MPI_REQUIRE( MPI_Comm_size(aggComm, &aggSize) );
+  Vector<int> aggProcs(aggSize);
+  BL_MPI_REQUIRE( MPI_Gather(&myProc, 1, MPI_INT, aggProcs.dataPtr(), 1, MPI_INT, 0, aggComm) );
+
+  // ---- the data are sent in chunks, so the aggregator never holds more
+  // ---- than two chunks of the other ranks' data
+  const long maxChunk(std::min(aggregatorChunkSize, static_cast<long>(std::numeric_limits<int>::max())));
+
+  if(aggRank != 0) {    // ---- phase one, send to the aggregator
+    for(long pos(0); pos < nbytes; pos += maxChunk) {
+      int n(std::min(nbytes - pos, maxChunk));
+      BL_MPI_REQUIRE( MPI_Send(const_cast<char *>(data) + pos, n, MPI_CHAR, 0, tag, aggComm) );
+    }
+  } else {
+
+    // ---- phase two.  the file is not truncated on opening since other
+    // ---- aggregators may be writing to it.
+    int fd(::open(fullFileName.c_str(), O_WRONLY | O_CREAT, 0666));
+    if(fd < 0) {
+      amrex::FileOpenFailed(fullFileName);
+    }
+    auto writeAt = [&] (const char *buf, long n, long offset) {
+      for(long pos(0); pos < n; ) {
+        ssize_t w(::pwrite(fd, buf + pos, n - pos, offset + pos));
+        if(w < 0) {
+          amrex::Abort("**** Error in NFilesIter::WriteAggregated:  write failed for " + fullFileName);
+        }
+        pos += w;
+      }
+    };
+
+    writeAt(data, nbytes, fileOffset[myProc]);
+
+    // ---- the chunks of the other ranks, in the order they are sent
+    struct Chunk { int src; long n, offset; };
+    Vector<Chunk> chunks;
+    long bufSize(0);
+    for(int i(1); i < aggSize; ++i) {
+      long n(allBytes[aggProcs[i]]);
+      for(long pos(0); pos < n; pos += maxChunk) {
+        chunks.push_back({i, std::min(n - pos, maxChunk), fileOffset[aggProcs[i]] + pos});
+        bufSize = std::max(bufSize, chunks.back().n);
+      }
+    }
+
+    // ---- receive the next chunk while writing the current one
+    const int nChunks(chunks.size());
+    std::unique_ptr<char[]> aggData[2];
+    if(nChunks > 0) {
+      aggData[0].reset(new char[bufSize]);
+      if(nChunks > 1) {
+        aggData[1].reset(new char[bufSize]);
+      }
+    }
+    MPI_Request req[2];
+    auto postRecv = [&] (int c) {
+      BL_MPI_REQUIRE( MPI_Irecv(aggData[c % 2].get(), chunks[c].n, MPI_CHAR,
+                                chunks[c].src, tag, aggComm, &req[c % 2]) );
+    };
+    if(nChunks > 0) {
+      postRecv(0);
+    }
+    for(int c(0); c < nChunks; ++c) {
+      BL_MPI_REQUIRE( MPI_Wait(&req[c % 2], MPI_STATUS_IGNORE) );
+      if(c + 1 < nChunks) {
+        postRecv(c + 1);
+      }
+      writeAt(aggData[c % 2].get(), chunks[c].n, chunks[c].offset);
+    }
+
+    // ---- the aggregator of the last rank removes anything beyond the data
+    for(int i(0); i < aggSize; ++i) {
+      if(aggProcs[i] == lastRank[fileNumber]) {
+        if(::ftruncate(fd, fileSize[fileNumber]) != 0) {
+          amrex::Abort("**** Error in NFilesIter::WriteAggregated:  truncate failed for " + fullFileName);
+        }
+      }
+    }
+    if(::close(fd) != 0) {
+      amrex::Abort("**** Error in NFilesIter::WriteAggregated:  close failed for " + fullFileName);
+    }
+  }
+
+  BL_MPI_REQUIRE( MPI_Comm_free(&aggComm) );
+  BL_MPI_REQUIRE( MPI_Comm_free(&fileComm) );
+  BL_MPI_REQUIRE( MPI_Comm_free(&nodeComm) );
+
+#else
+  for( ; ReadyToWrite(); ++(*this)) {
+    fileStream.write(data, nbytes);
+  }
+#endif
+
+  finishedWriting = true;
+}
+
+
 std::streampos NFilesIter::SeekPos() {
   return fileStream.tellp();
 }
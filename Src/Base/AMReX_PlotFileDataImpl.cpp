@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <AMReX_PlotFileDataImpl.H>
 #include <AMReX_ParallelDescriptor.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_Utility.H>
 #include <AMReX_VisMF.H>
 
 namespace amrex {
@@ -70,6 +72,7 @@ PlotFileDataImpl::PlotFileDataImpl (std::string const& plotfile_name)
 
     m_mf_name.resize(m_nlevels);
     m_vismf.resize(m_nlevels);
+    m_pyramid.resize(m_nlevels);
     m_ba.resize(m_nlevels);
     m_dmap.resize(m_nlevels);
     m_ngrow.resize(m_nlevels);
@@ -135,11 +138,118 @@ PlotFileDataImpl::get (int level, std::string const& varname) noexcept
         for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
             int gid = mfi.index();
             FArrayBox& dstfab = mf[mfi];
-            std::unique_ptr<FArrayBox> srcfab(m_vismf[level]->readFAB(gid, icomp));
-            dstfab.copy(*srcfab);
+            dstfab.copy(m_vismf[level]->GetFab(gid, icomp));
+            m_vismf[level]->clear(gid, icomp);
         }
     }
     return mf;
 }
 
+const FArrayBox&
+PlotFileDataImpl::getFab (int level, int gid, std::string const& varname) noexcept
+{
+    auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
+    if (r == std::end(m_var_names)) {
+        amrex::Abort("PlotFileDataImpl::getFab: varname not found "+varname);
+    }
+    int icomp = std::distance(std::begin(m_var_names), r);
+    return m_vismf[level]->GetFab(gid, icomp);
+}
+
+void
+PlotFileDataImpl::clearFab (int level, int gid) noexcept
+{
+    m_vismf[level]->clear(gid);
+}
+
+bool
+PlotFileDataImpl::hasCoarsened (int level, int ratio) noexcept
+{
+    return ratio == 1 or pyramid(level, ratio) != nullptr;
+}
+
+MultiFab
+PlotFileDataImpl::getCoarsened (int level, std::string const& varname, int ratio) noexcept
+{
+    if (ratio == 1) {
+        return get(level, varname);
+    }
+
+    auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
+    if (r == std::end(m_var_names)) {
+        amrex::Abort("PlotFileDataImpl::getCoarsened: varname not found "+varname);
+    }
+    int icomp = std::distance(std::begin(m_var_names), r);
+
+    VisMF* vismf = pyramid(level, ratio);
+    if (vismf) {
+        MultiFab mf(vismf->boxArray(), m_dmap[level], 1, 0);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            int gid = mfi.index();
+            mf[mfi].copy(vismf->GetFab(gid, icomp));
+            vismf->clear(gid, icomp);
+        }
+        return mf;
+    }
+
+    // No pyramid, so average the full data down.
+    IntVect rr(ratio);
+    for (int idim = m_spacedim; idim < AMREX_SPACEDIM; ++idim) {
+        rr[idim] = 1;
+    }
+    if (!m_ba[level].coarsenable(rr)) {
+        amrex::Abort("PlotFileDataImpl::getCoarsened: level " + std::to_string(level)
+                     + " cannot be coarsened by " + std::to_string(ratio));
+    }
+    const MultiFab& fine = get(level, varname);
+    MultiFab mf(amrex::coarsen(m_ba[level], rr), m_dmap[level], 1, 0);
+    amrex::average_down(fine, mf, 0, 1, rr);
+    return mf;
+}
+
+Real
+PlotFileDataImpl::min (int level, std::string const& varname) noexcept
+{
+    auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
+    if (r == std::end(m_var_names)) {
+        amrex::Abort("PlotFileDataImpl::min: varname not found "+varname);
+    }
+    int icomp = std::distance(std::begin(m_var_names), r);
+    if (m_vismf[level]->hasMinMax()) {
+        return m_vismf[level]->min(icomp);
+    } else {
+        return get(level, varname).min(0);
+    }
+}
+
+Real
+PlotFileDataImpl::max (int level, std::string const& varname) noexcept
+{
+    auto r = std::find(std::begin(m_var_names), std::end(m_var_names), varname);
+    if (r == std::end(m_var_names)) {
+        amrex::Abort("PlotFileDataImpl::max: varname not found "+varname);
+    }
+    int icomp = std::distance(std::begin(m_var_names), r);
+    if (m_vismf[level]->hasMinMax()) {
+        return m_vismf[level]->max(icomp);
+    } else {
+        return get(level, varname).max(0);
+    }
+}
+
+VisMF*
+PlotFileDataImpl::pyramid (int level, int ratio)
+{
+    auto it = m_pyramid[level].find(ratio);
+    if (it == m_pyramid[level].end()) {
+        std::unique_ptr<VisMF> vismf;
+        const std::string name = m_mf_name[level] + "_" + std::to_string(ratio) + "x";
+        if (m_ncomp > 0 and amrex::FileExists(name + "_H")) {
+            vismf.reset(new VisMF(name));
+        }
+        it = m_pyramid[level].emplace(ratio, std::move(vismf)).first;
+    }
+    return it->second.get();
+}
+
 }
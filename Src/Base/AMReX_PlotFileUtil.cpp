@@ -4,6 +4,8 @@
 
 #include <AMReX_VisMF.H>
 #include <AMReX_PlotFileUtil.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFabUtil.H>
 
 #ifdef AMREX_USE_EB
 #include <AMReX_EBFabFactory.H>
@@ -15,6 +17,69 @@
 
 namespace amrex {
 
+namespace {
+
+//! The error bound of each variable, or nothing if all are written exactly.
+Vector<Real> PlotfileTolerance (const Vector<std::string> &varnames)
+{
+    ParmParse pp("plotfile");
+    Real deftol(0.0);
+    pp.query("lossy_tolerance", deftol);
+
+    Vector<Real> tol(varnames.size(), deftol);
+    bool lossy(false);
+    for (int i = 0; i < varnames.size(); ++i) {
+        pp.query(("lossy_tolerance." + varnames[i]).c_str(), tol[i]);
+        lossy = lossy || tol[i] > 0.0;
+    }
+    if (!lossy) {
+        tol.clear();
+    }
+    return tol;
+}
+
+//! How many coarsened copies of each level go into the preview pyramid.
+int PlotfilePyramidLevels ()
+{
+    ParmParse pp("plotfile");
+    int nlevels(0);
+    pp.query("pyramid_levels", nlevels);
+    return nlevels;
+}
+
+/**
+* \brief Write data averaged down by 2, 4, ... next to mfname, as
+* mfname_2x, mfname_4x, ..., for as long as the boxes can be coarsened.
+*/
+void WritePyramid (const MultiFab &data, const std::string &mfname, int nlevels,
+                   const Vector<Real> &tolerance)
+{
+    BL_PROFILE("WritePyramid()");
+
+    const VisMF::Header::Version currentVersion(VisMF::GetHeaderVersion());
+    if (currentVersion != VisMF::Header::Compressed_v1) {
+        VisMF::SetHeaderVersion(VisMF::Header::NoFabHeaderMinMax_v1);
+    }
+
+    const MultiFab *fine = &data;
+    std::unique_ptr<MultiFab> crse;
+    for (int ilev = 1, ratio = 2; ilev <= nlevels && data.boxArray().coarsenable(ratio);
+         ++ilev, ratio *= 2)
+    {
+        std::unique_ptr<MultiFab> tmp(new MultiFab(amrex::coarsen(fine->boxArray(), 2),
+                                                   fine->DistributionMap(), fine->nComp(), 0));
+        amrex::average_down(*fine, *tmp, 0, fine->nComp(), 2);
+        VisMF::Write(*tmp, mfname + "_" + std::to_string(ratio) + "x", VisMF::NFiles,
+                     false, tolerance);
+        crse = std::move(tmp);
+        fine = crse.get();
+    }
+
+    VisMF::SetHeaderVersion(currentVersion);
+}
+
+}
+
 std::string LevelPath (int level, const std::string &levelPrefix)
 {
     return Concatenate(levelPrefix, level, 1);  // e.g., Level_5
@@ -173,6 +238,16 @@ WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
 
     int finest_level = nlevels-1;
 
+    const Vector<Real> tolerance(PlotfileTolerance(varnames));
+    const VisMF::Header::Version currentVersion(VisMF::GetHeaderVersion());
+    if (!tolerance.empty()) {
+        VisMF::SetHeaderVersion(VisMF::Header::Compressed_v1);
+    }
+    const bool compressed(VisMF::GetHeaderVersion() == VisMF::Header::Compressed_v1);
+    const int npyramid(PlotfilePyramidLevels());
+    Real dWriteTime(amrex::second());
+    long nBytesWritten(0), nBytesData(0);
+
 //    int saveNFiles(VisMF::GetNOutFiles());
 //    VisMF::SetNOutFiles(std::max(1024,saveNFiles));
 
@@ -222,7 +297,25 @@ WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
         } else {
             data = mf[level];
         }
-	VisMF::Write(*data, MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix));
+	nBytesWritten += VisMF::Write(*data, MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix),
+                                      VisMF::NFiles, false, tolerance);
+        nBytesData += data->boxArray().numPts() * data->nComp() * sizeof(Real);
+        if (npyramid > 0) {
+            WritePyramid(*data, MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix),
+                         npyramid, tolerance);
+        }
+    }
+
+    VisMF::SetHeaderVersion(currentVersion);
+
+    if (compressed) {
+        dWriteTime = amrex::second() - dWriteTime;
+        ParallelDescriptor::ReduceLongSum(nBytesWritten, ParallelDescriptor::IOProcessorNumber());
+        ParallelDescriptor::ReduceRealMax(dWriteTime, ParallelDescriptor::IOProcessorNumber());
+        amrex::Print() << "WriteMultiLevelPlotfile " << plotfilename << ":  compression ratio "
+                       << Real(nBytesData) / Real(std::max(nBytesWritten, 1L)) << ",  "
+                       << Real(nBytesData) / (1024.0*1024.0) / std::max(dWriteTime, Real(1.e-12))
+                       << " MB/s\n";
     }
 
 //    VisMF::SetNOutFiles(saveNFiles);
@@ -0,0 +1,310 @@
+
+#include <algorithm>
+
+#include <AMReX_TArena.H>
+#include <AMReX_BLassert.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParallelDescriptor.H>
+
+namespace amrex {
+
+struct TArena::ThreadCache
+{
+    explicit ThreadCache (int nbins) : bins(nbins) {}
+    //! One free list per size class.
+    std::vector<std::vector<void*> > bins;
+    //! Bytes held on the free lists.
+    std::size_t bytes = 0;
+};
+
+namespace {
+    std::atomic<unsigned long> tarena_next_id{0};
+    //
+    // Each thread keeps a pointer to its cache in every TArena it has used.
+    // Arenas are identified by a unique id rather than their address so that
+    // an entry left behind by a destroyed arena can never be matched again.
+    //
+    thread_local std::vector<std::pair<unsigned long, TArena::ThreadCache*> > tl_caches;
+}
+
+constexpr std::size_t TArena::not_pooled;
+constexpr int TArena::min_order;
+constexpr int TArena::bins_per_order;
+
+TArena::TArena (std::size_t max_cached_size, std::size_t max_thread_cache, ArenaInfo info)
+    : m_max_cached_size(max_cached_size),
+      m_max_thread_cache(max_thread_cache),
+      m_id(tarena_next_id++),
+      m_num_alloc(0),
+      m_num_thread_hits(0),
+      m_num_pool_hits(0),
+      m_num_system_alloc(0),
+      m_used(0),
+      m_bytes_in_use(0),
+      m_class_bytes_in_use(0),
+      m_bytes_cached(0)
+{
+    arena_info = info;
+    //
+    // Four size classes per power of two, rounded to the arena alignment.
+    //
+    for (int order = min_order; ; ++order)
+    {
+        const std::size_t base = std::size_t(1) << order;
+        for (int s = 0; s < bins_per_order; ++s)
+        {
+            const std::size_t sz = Arena::align(base + s*(base/bins_per_order));
+            if (m_bin_size.empty() || sz > m_bin_size.back()) {
+                m_bin_size.push_back(sz);
+            }
+        }
+        if (m_bin_size.back() >= m_max_cached_size) break;
+    }
+
+    m_pool.resize(m_bin_size.size());
+}
+
+TArena::~TArena ()
+{
+    for (auto const& kv : m_alloc) {
+        deallocate_system(kv.first, kv.second);
+    }
+}
+
+std::size_t
+TArena::binIndex (std::size_t nbytes) const noexcept
+{
+    if (nbytes > m_max_cached_size) return not_pooled;
+    auto it = std::lower_bound(m_bin_size.begin(), m_bin_size.end(), nbytes);
+    return (it == m_bin_size.end()) ? not_pooled : static_cast<std::size_t>(it - m_bin_size.begin());
+}
+
+TArena::ThreadCache&
+TArena::threadCache ()
+{
+    for (auto const& p : tl_caches) {
+        if (p.first == m_id) return *p.second;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_caches.emplace_back(new ThreadCache(nbins()));
+    tl_caches.emplace_back(m_id, m_caches.back().get());
+    return *m_caches.back();
+}
+
+void*
+TArena::alloc (std::size_t nbytes)
+{
+    ++m_num_alloc;
+
+    const std::size_t bin = binIndex(nbytes);
+    std::size_t class_bytes;
+    void* block = nullptr;
+
+    if (bin == not_pooled)
+    {
+        class_bytes = Arena::align(nbytes);
+        block = allocate_system(class_bytes + Arena::align_size);
+        ++m_num_system_alloc;
+        m_used += class_bytes + Arena::align_size;
+    }
+    else
+    {
+        class_bytes = m_bin_size[bin];
+
+        ThreadCache& tc = threadCache();
+        auto& fl = tc.bins[bin];
+        if (!fl.empty())
+        {
+            block = fl.back();
+            fl.pop_back();
+            tc.bytes -= class_bytes;
+            m_bytes_cached -= class_bytes;
+            ++m_num_thread_hits;
+        }
+        else
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto& pl = m_pool[bin];
+                if (!pl.empty()) {
+                    block = pl.back();
+                    pl.pop_back();
+                }
+            }
+
+            if (block)
+            {
+                m_bytes_cached -= class_bytes;
+                ++m_num_pool_hits;
+            }
+            else
+            {
+                const std::size_t N = class_bytes + Arena::align_size;
+                block = allocate_system(N);
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_alloc[block] = N;
+                }
+                ++m_num_system_alloc;
+                m_used += N;
+            }
+        }
+    }
+
+    Header* h = static_cast<Header*>(block);
+    h->nbytes = nbytes;
+    h->bin = bin;
+
+    m_bytes_in_use += nbytes;
+    m_class_bytes_in_use += class_bytes;
+
+    return static_cast<char*>(block) + Arena::align_size;
+}
+
+void
+TArena::free (void* vp)
+{
+    if (vp == nullptr) return;
+
+    void* block = static_cast<char*>(vp) - Arena::align_size;
+    const Header* h = static_cast<Header*>(block);
+    const std::size_t bin = h->bin;
+
+    m_bytes_in_use -= h->nbytes;
+
+    if (bin == not_pooled)
+    {
+        const std::size_t class_bytes = Arena::align(h->nbytes);
+        m_class_bytes_in_use -= class_bytes;
+        m_used -= class_bytes + Arena::align_size;
+        deallocate_system(block, class_bytes + Arena::align_size);
+        return;
+    }
+
+    BL_ASSERT(static_cast<int>(bin) < nbins());
+
+    const std::size_t class_bytes = m_bin_size[bin];
+    m_class_bytes_in_use -= class_bytes;
+
+    ThreadCache& tc = threadCache();
+    tc.bins[bin].push_back(block);
+    tc.bytes += class_bytes;
+    m_bytes_cached += class_bytes;
+
+    if (tc.bytes > m_max_thread_cache) spill(tc);
+}
+
+void
+TArena::spill (ThreadCache& tc)
+{
+    //
+    // Hand the older half of every free list over to the global pool, so that
+    // memory freed by one thread can be reused by the others.
+    //
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int bin = 0; bin < nbins(); ++bin)
+    {
+        auto& fl = tc.bins[bin];
+        const std::size_t n = (fl.size()+1)/2;
+        if (n == 0) continue;
+        auto& pl = m_pool[bin];
+        pl.insert(pl.end(), fl.begin(), fl.begin()+n);
+        fl.erase(fl.begin(), fl.begin()+n);
+        tc.bytes -= n*m_bin_size[bin];
+    }
+}
+
+void
+TArena::release ()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto release_list = [&] (std::vector<void*>& fl)
+    {
+        for (void* block : fl) {
+            auto it = m_alloc.find(block);
+            BL_ASSERT(it != m_alloc.end());
+            m_used -= it->second;
+            m_bytes_cached -= it->second - Arena::align_size;
+            deallocate_system(it->first, it->second);
+            m_alloc.erase(it);
+        }
+        fl.clear();
+    };
+
+    for (auto& tc : m_caches) {
+        for (auto& fl : tc->bins) {
+            release_list(fl);
+        }
+        tc->bytes = 0;
+    }
+    for (auto& pl : m_pool) {
+        release_list(pl);
+    }
+}
+
+std::size_t
+TArena::heap_space_used () const noexcept
+{
+    return m_used;
+}
+
+TArena::Stats
+TArena::stats () const noexcept
+{
+    Stats s;
+    s.num_alloc          = m_num_alloc;
+    s.num_thread_hits    = m_num_thread_hits;
+    s.num_pool_hits      = m_num_pool_hits;
+    s.num_system_alloc   = m_num_system_alloc;
+    s.heap_space_used    = m_used;
+    s.bytes_in_use       = m_bytes_in_use;
+    s.class_bytes_in_use = m_class_bytes_in_use;
+    s.bytes_cached       = m_bytes_cached;
+    return s;
+}
+
+void
+TArena::PrintStats (const std::string& name) const
+{
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+    const Stats s = stats();
+
+    const long MB = 1024*1024;
+    long mbytes[3] = { static_cast<long>(s.heap_space_used / MB),
+                       static_cast<long>(s.bytes_in_use / MB),
+                       static_cast<long>(s.bytes_cached / MB) };
+    long min_mbytes[3] = { mbytes[0], mbytes[1], mbytes[2] };
+    long max_mbytes[3] = { mbytes[0], mbytes[1], mbytes[2] };
+    ParallelDescriptor::ReduceLongMin(min_mbytes, 3, IOProc);
+    ParallelDescriptor::ReduceLongMax(max_mbytes, 3, IOProc);
+
+    long counts[4] = { s.num_alloc, s.num_thread_hits, s.num_pool_hits, s.num_system_alloc };
+    ParallelDescriptor::ReduceLongSum(counts, 4, IOProc);
+
+    //
+    // Internal fragmentation is the size-class rounding of live blocks;
+    // external is memory held on free lists relative to all memory held.
+    //
+    Real frag[2] = { (s.class_bytes_in_use > 0)
+                     ? Real(1.0) - Real(s.bytes_in_use)/Real(s.class_bytes_in_use) : Real(0.0),
+                     (s.heap_space_used > 0)
+                     ? Real(s.bytes_cached)/Real(s.heap_space_used) : Real(0.0) };
+    ParallelDescriptor::ReduceRealMax(frag, 2, IOProc);
+
+    const Real nalloc = std::max(counts[0], 1L);
+
+    amrex::Print() << "[" << name << "] space (MB) used spread across MPI: ["
+                   << min_mbytes[0] << " ... " << max_mbytes[0] << "]\n"
+                   << "[" << name << "] live (MB): [" << min_mbytes[1] << " ... " << max_mbytes[1]
+                   << "], cached (MB): [" << min_mbytes[2] << " ... " << max_mbytes[2] << "]\n"
+                   << "[" << name << "] allocs: " << counts[0]
+                   << ", thread cache hits: " << Real(100.0)*counts[1]/nalloc << "%"
+                   << ", pool hits: " << Real(100.0)*counts[2]/nalloc << "%"
+                   << ", system: " << Real(100.0)*counts[3]/nalloc << "%\n"
+                   << "[" << name << "] max fragmentation internal: " << Real(100.0)*frag[0]
+                   << "%, external: " << Real(100.0)*frag[1] << "%\n";
+}
+
+}
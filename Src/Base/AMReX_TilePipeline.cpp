@@ -0,0 +1,163 @@
+
+#include <AMReX_TilePipeline.H>
+#include <AMReX_BLProfiler.H>
+
+namespace amrex {
+
+int
+TilePipeline::addTemp (int ncomp, IndexType ixtype)
+{
+    BL_ASSERT(ncomp > 0);
+    m_temps.push_back({ncomp, ixtype});
+    m_finalized = false;
+    return m_temps.size()-1;
+}
+
+void
+TilePipeline::addStage (const std::string& name, const Vector<int>& outputs,
+                        const Vector<Input>& inputs, StageFunction f)
+{
+    m_stages.push_back({name, outputs, inputs, std::move(f), {}, {}});
+    m_finalized = false;
+}
+
+void
+TilePipeline::addStage (const std::string& name, const Vector<int>& outputs,
+                        const Vector<Input>& inputs,
+                        const Vector<const FabArrayBase*>& fab_outputs,
+                        const Vector<FabInput>& fab_inputs, StageFunction f)
+{
+    m_stages.push_back({name, outputs, inputs, std::move(f), fab_outputs, fab_inputs});
+    m_finalized = false;
+}
+
+void
+TilePipeline::finalize ()
+{
+    if (m_finalized) return;
+
+    const int ntemps  = m_temps.size();
+    const int nstages = m_stages.size();
+
+    //
+    // Every temporary must be written before it is read.
+    //
+    Vector<char> written(ntemps, 0);
+    for (const auto& s : m_stages)
+    {
+        for (const auto& in : s.inputs) {
+            if (in.first < 0 || in.first >= ntemps || !written[in.first]) {
+                amrex::Abort("TilePipeline: stage " + s.name + " reads temporary "
+                             + std::to_string(in.first) + " before any stage writes it");
+            }
+        }
+        for (int t : s.outputs) {
+            if (t < 0 || t >= ntemps) {
+                amrex::Abort("TilePipeline: stage " + s.name + " writes unknown temporary "
+                             + std::to_string(t));
+            }
+            written[t] = 1;
+        }
+    }
+
+    //
+    // Going backward, a stage computes where later stages read its outputs,
+    // and a temporary covers the largest region any stage writes it on.
+    //
+    m_stage_ngrow.assign(nstages, IntVect::TheZeroVector());
+    m_temp_ngrow.assign(ntemps, IntVect::TheZeroVector());
+    Vector<IntVect> need(ntemps, IntVect::TheZeroVector());
+
+    for (int is = nstages-1; is >= 0; --is)
+    {
+        const Stage& s = m_stages[is];
+
+        IntVect ng = IntVect::TheZeroVector();
+        for (int t : s.outputs) {
+            ng.max(need[t]);
+        }
+        m_stage_ngrow[is] = ng;
+
+        for (int t : s.outputs) {
+            m_temp_ngrow[t].max(ng);
+            need[t] = IntVect::TheZeroVector();
+        }
+        for (const auto& in : s.inputs) {
+            need[in.first].max(ng + in.second);
+        }
+    }
+
+    //
+    // A FabArray written by the pipeline is only complete on the tiles it
+    // has run on, so it can be neither read nor written beyond the tile box.
+    //
+    for (int is = 0; is < nstages; ++is)
+    {
+        const Stage& s = m_stages[is];
+
+        if (!s.fab_outputs.empty() && m_stage_ngrow[is] != IntVect::TheZeroVector()) {
+            amrex::Abort("TilePipeline: stage " + s.name + " writes a FabArray"
+                         " but runs on a grown box for the temporaries it writes");
+        }
+
+        for (const auto& in : s.fab_inputs)
+        {
+            if (m_stage_ngrow[is] + in.second == IntVect::TheZeroVector()) continue;
+
+            for (const auto& w : m_stages) {
+                for (const FabArrayBase* fab : w.fab_outputs) {
+                    if (fab == in.first) {
+                        amrex::Abort("TilePipeline: stage " + s.name + " reads ghost cells"
+                                     " of a FabArray that stage " + w.name + " writes");
+                    }
+                }
+            }
+        }
+    }
+
+    m_finalized = true;
+}
+
+void
+TilePipeline::run (const FabArrayBase& fa, const MFItInfo& info)
+{
+    BL_PROFILE("TilePipeline::run()");
+
+    finalize();
+
+    const int ntemps  = m_temps.size();
+    const int nstages = m_stages.size();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    {
+        //
+        // The temporaries of a thread are reused from tile to tile.  On the
+        // GPU they are handed to Elixirs and reallocated instead.
+        //
+        Vector<FArrayBox> temps(ntemps);
+        Vector<Elixir>    elis(ntemps);
+
+        for (MFIter mfi(fa, info); mfi.isValid(); ++mfi)
+        {
+            const Box& tbx = mfi.tilebox();
+
+            for (int t = 0; t < ntemps; ++t)
+            {
+                const Box& bx = amrex::convert(amrex::grow(tbx, m_temp_ngrow[t]), m_temps[t].ixtype);
+                temps[t].resize(bx, m_temps[t].ncomp);
+                elis[t] = temps[t].elixir();
+            }
+
+            const Tile tile(mfi, temps);
+
+            for (int is = 0; is < nstages; ++is)
+            {
+                m_stages[is].f(amrex::grow(tbx, m_stage_ngrow[is]), tile);
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,317 @@
+
+#include <map>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <AMReX_TileSizeTuner.H>
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+namespace amrex {
+
+namespace {
+
+    bool initialized = false;
+    bool enable = true;
+    int  ntrials = 3;
+    int  verbose = 0;
+    std::string tuner_file;
+
+    Vector<IntVect> candidates;
+
+    struct Record
+    {
+        //! Best time per cell of each candidate so far.
+        Vector<double> best;
+        //! Number of invocations started.
+        long ninvoc = 0;
+        //! Number of trial invocations finished.
+        long ntried = 0;
+        //! Index of the chosen candidate, or -1 while still tuning.
+        int chosen = -1;
+        //! A tile size read from the file, which need not be a candidate.
+        bool from_file = false;
+        IntVect tilesize;
+        //! Time spent in the region after locking in.
+        double tuned_time = 0.0;
+        long tuned_calls = 0;
+    };
+
+    std::map<std::string,Record> records;
+    // Guards records.  It is never held across a collective operation.
+    std::mutex tuner_mutex;
+
+    bool ready (Record const& r) noexcept
+    {
+        return r.chosen < 0 && !r.from_file
+            && r.ntried >= static_cast<long>(candidates.size())*ntrials;
+    }
+
+    void read_file ()
+    {
+        std::ifstream ifs(tuner_file);
+        if (!ifs.good()) return;
+        std::string line;
+        while (std::getline(ifs, line))
+        {
+            std::istringstream is(line);
+            std::string name;
+            IntVect ts;
+            if (!(is >> name)) continue;
+            bool ok = true;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                if (!(is >> ts[d])) ok = false;
+            }
+            if (ok) {
+                Record& r = records[name];
+                r.from_file = true;
+                r.tilesize = ts;
+            }
+        }
+    }
+
+    void write_file ()
+    {
+        if (!ParallelDescriptor::IOProcessor()) return;
+        std::ofstream ofs(tuner_file);
+        if (!ofs.good()) {
+            amrex::Warning("TileSizeTuner: cannot write " + tuner_file);
+            return;
+        }
+        for (auto const& kv : records) {
+            Record const& r = kv.second;
+            if (r.chosen >= 0 || r.from_file) {
+                ofs << kv.first;
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) ofs << " " << r.tilesize[d];
+                ofs << "\n";
+            }
+        }
+    }
+}
+
+void
+TileSizeTuner::Initialize ()
+{
+    if (initialized) return;
+    initialized = true;
+
+    ParmParse pp("tiletuner");
+    pp.query("enable", enable);
+    pp.query("ntrials", ntrials);
+    pp.query("v", verbose);
+    pp.query("file", tuner_file);
+    ntrials = std::max(ntrials, 1);
+
+    candidates.clear();
+    candidates.push_back(FabArrayBase::mfiter_tile_size);
+
+    Vector<int> cand;
+    if (pp.queryarr("candidates", cand) && static_cast<int>(cand.size()) >= AMREX_SPACEDIM)
+    {
+        for (int i = 0; i+AMREX_SPACEDIM <= static_cast<int>(cand.size()); i += AMREX_SPACEDIM) {
+            IntVect ts(AMREX_D_DECL(cand[i],cand[i+1],cand[i+2]));
+            if (ts != candidates[0]) candidates.push_back(ts);
+        }
+    }
+    else
+    {
+        const int big = 1024000;
+        Vector<IntVect> defaults
+            { IntVect(AMREX_D_DECL(big, 8, 8)),
+              IntVect(AMREX_D_DECL(big,16,16)),
+              IntVect(AMREX_D_DECL(big, 4, 4)),
+              IntVect(AMREX_D_DECL(big,32, 8)),
+              IntVect(AMREX_D_DECL( 64,16,16)),
+              IntVect(AMREX_D_DECL( 32, 8, 8)) };
+        for (auto const& ts : defaults) {
+            if (std::find(candidates.begin(), candidates.end(), ts) == candidates.end()) {
+                candidates.push_back(ts);
+            }
+        }
+    }
+
+    if (!tuner_file.empty()) read_file();
+
+    amrex::ExecOnFinalize(TileSizeTuner::Finalize);
+}
+
+void
+TileSizeTuner::Finalize ()
+{
+    if (!initialized) return;
+    Decide();
+    if (verbose > 0) PrintSummary();
+    if (!tuner_file.empty()) write_file();
+    records.clear();
+    candidates.clear();
+    initialized = false;
+}
+
+void
+TileSizeTuner::Decide ()
+{
+#ifdef _OPENMP
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!omp_in_parallel(),
+                                     "TileSizeTuner::Decide: called in a parallel region");
+#endif
+
+    //
+    // The best times per cell of every region that has tried all its
+    // candidates.  A process without cells has no say.
+    //
+    Vector<std::string> names;
+    Vector<Real> slowest;
+    {
+        std::lock_guard<std::mutex> lock(tuner_mutex);
+        for (auto const& kv : records) {
+            if (ready(kv.second)) {
+                names.push_back(kv.first);
+                for (double t : kv.second.best) {
+                    slowest.push_back((t == std::numeric_limits<double>::max())
+                                      ? 0.0 : static_cast<Real>(t));
+                }
+            }
+        }
+    }
+
+    int n[2] = { static_cast<int>(names.size()), -static_cast<int>(names.size()) };
+    ParallelDescriptor::ReduceIntMax(n, 2);
+    if (n[0] != -n[1]) {
+        amrex::Abort("TileSizeTuner::Decide: regions were invoked a different number of times on different processes");
+    }
+    if (names.empty()) return;
+
+    //
+    // Every process locks in the tile size whose slowest process is fastest.
+    //
+    ParallelDescriptor::ReduceRealMax(slowest.dataPtr(), slowest.size());
+
+    std::lock_guard<std::mutex> lock(tuner_mutex);
+    const int N = candidates.size();
+    for (int k = 0, nr = names.size(); k < nr; ++k)
+    {
+        Record& r = records[names[k]];
+        for (int i = 0; i < N; ++i) {
+            r.best[i] = slowest[k*N+i];
+        }
+        r.chosen = static_cast<int>(std::min_element(r.best.begin(), r.best.end())
+                                    - r.best.begin());
+        r.tilesize = candidates[r.chosen];
+        if (verbose > 1) {
+            amrex::Print() << "TileSizeTuner: " << names[k] << " uses tile size "
+                           << r.tilesize << "\n";
+        }
+    }
+}
+
+TileSizeTuner::TileSizeTuner (const std::string& name, const FabArrayBase& fa)
+    : m_name(name),
+      m_tilesize(FabArrayBase::mfiter_tile_size),
+      m_candidate(-1),
+      m_ncells(0),
+      m_t0(0.0),
+      m_timed(false)
+{
+    // Tiles are not used on the GPU, and the decision is made on all
+    // processes, which a sub-communicator would not reach.
+    if (!enable || candidates.empty() || !TilingIfNotGPU() ||
+        ParallelContext::NProcsSub() != ParallelDescriptor::NProcs()) {
+        return;
+    }
+
+    for (int i : fa.IndexArray()) {
+        m_ncells += fa.box(i).numPts();
+    }
+
+    bool decide;
+    {
+        std::lock_guard<std::mutex> lock(tuner_mutex);
+        decide = ready(records[m_name]);
+    }
+    if (decide) Decide();
+
+    std::lock_guard<std::mutex> lock(tuner_mutex);
+
+    Record& r = records[m_name];
+    if (r.from_file || r.chosen >= 0)
+    {
+        m_tilesize = r.tilesize;
+    }
+    else
+    {
+        if (r.best.empty()) {
+            r.best.resize(candidates.size(), std::numeric_limits<double>::max());
+        }
+        m_candidate = std::min(static_cast<int>(r.ninvoc / ntrials),
+                               static_cast<int>(candidates.size())-1);
+        m_tilesize = candidates[m_candidate];
+    }
+    ++r.ninvoc;
+
+    m_timed = true;
+    m_t0 = amrex::second();
+}
+
+TileSizeTuner::~TileSizeTuner ()
+{
+    if (!m_timed) return;
+
+    const double t = amrex::second() - m_t0;
+
+    std::lock_guard<std::mutex> lock(tuner_mutex);
+
+    Record& r = records[m_name];
+    if (m_candidate < 0)
+    {
+        r.tuned_time += t;
+        ++r.tuned_calls;
+    }
+    else
+    {
+        // Taking the minimum discards invocations slowed by first touch or noise.
+        if (m_ncells > 0) {
+            r.best[m_candidate] = std::min(r.best[m_candidate], t/m_ncells);
+        }
+        ++r.ntried;
+    }
+}
+
+void
+TileSizeTuner::PrintSummary ()
+{
+    if (records.empty()) return;
+
+    amrex::Print() << "TileSizeTuner summary (tuned call times of the I/O process):\n";
+    for (auto const& kv : records)
+    {
+        Record const& r = kv.second;
+        amrex::Print() << "  " << kv.first << ": ";
+        if (r.from_file) {
+            amrex::Print() << "tile size " << r.tilesize << " from " << tuner_file;
+        } else if (r.chosen >= 0) {
+            amrex::Print() << "tile size " << r.tilesize << ", best time per cell "
+                           << r.best[r.chosen]*1.e9 << " ns vs. " << r.best[0]*1.e9
+                           << " ns with the default " << candidates[0];
+        } else {
+            amrex::Print() << "still tuning after " << r.ninvoc << " calls";
+        }
+        if (r.tuned_calls > 0) {
+            amrex::Print() << ", " << r.tuned_calls << " tuned calls averaging "
+                           << r.tuned_time/r.tuned_calls << " s";
+        }
+        amrex::Print() << "\n";
+    }
+}
+
+}
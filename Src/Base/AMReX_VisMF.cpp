@@ -1,14 +1,18 @@
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <vector>
 #include <deque>
 #include <cerrno>
 #include <atomic>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 #include <array>
 #include <numeric>
+#include <memory>
+#include <type_traits>
 
 #include <AMReX_ccse-mpi.H>
 #include <AMReX_Utility.H>
@@ -17,6 +21,14 @@
 #include <AMReX_NFiles.H>
 #include <AMReX_FPC.H>
 #include <AMReX_FabArrayUtility.H>
+#include <AMReX_FabCompress.H>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace amrex {
 
@@ -35,8 +47,13 @@ bool VisMF::useSingleWrite(false);
 bool VisMF::checkFilePositions(false);
 bool VisMF::usePersistentIFStreams(false);
 bool VisMF::useSynchronousReads(false);
+bool VisMF::useDirectReads(false);
 bool VisMF::useDynamicSetSelection(true);
 bool VisMF::allowSparseWrites(true);
+bool VisMF::useMmap(true);
+bool VisMF::binaryHeader(false);
+bool VisMF::aggregateWrites(false);
+int  VisMF::aggregatorRanks(0);
 
 long VisMF::ioBufferSize(VisMF::IO_Buffer_Size);
 
@@ -50,6 +67,535 @@ int VisMF::nMFFileInStreams(4);
 namespace
 {
     bool initialized = false;
+
+    //
+    // A compressed FAB is a table with the size of each compressed
+    // component as a little-endian 64-bit integer, followed by the
+    // FabCompress chunks of the components.
+    //
+    void putChunkSize (std::int64_t nbytes, char *p)
+    {
+        const std::uint64_t u(nbytes);
+        for(int b(0); b < 8; ++b) {
+            p[b] = static_cast<char>((u >> (8*b)) & 0xff);
+        }
+    }
+
+    std::int64_t getChunkSize (const char *p)
+    {
+        std::uint64_t u(0);
+        for(int b(0); b < 8; ++b) {
+            u |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[b])) << (8*b);
+        }
+        return static_cast<std::int64_t>(u);
+    }
+
+    /**
+    * \brief Append the compressed fab to out and return the number of bytes
+    * appended.  Component n is lossless unless tol[n] > 0.
+    */
+    long EncodeFab (const FArrayBox &fab, Vector<char> &out,
+                    const Vector<Real> &tol = Vector<Real>())
+    {
+        const int ncomp(fab.nComp());
+        const std::size_t npts(fab.box().numPts());
+        const std::size_t tableStart(out.size());
+        out.resize(tableStart + 8*ncomp);
+        for(int n(0); n < ncomp; ++n) {
+            const Real tolerance(n < tol.size() ? tol[n] : 0.0);
+            const std::size_t nbytes(FabCompress::Encode(fab.dataPtr(n), npts, tolerance, out));
+            putChunkSize(nbytes, out.dataPtr() + tableStart + 8*n);
+        }
+        return out.size() - tableStart;
+    }
+
+    //! Read a compressed FAB at the current position of is.  whichComp == -1 reads all components.
+    void DecodeFab (std::istream &is, int ncompOnDisk, int whichComp, FArrayBox &fab)
+    {
+        Vector<char> table(8*ncompOnDisk);
+        is.read(table.dataPtr(), table.size());
+
+        const int nlo(whichComp < 0 ? 0 : whichComp);
+        const int nhi(whichComp < 0 ? ncompOnDisk : whichComp + 1);
+        BL_ASSERT(fab.nComp() == nhi - nlo);
+
+        std::int64_t skipBytes(0), readBytes(0);
+        for(int n(0); n < nhi; ++n) {
+            if(n < nlo) {
+                skipBytes += getChunkSize(table.dataPtr() + 8*n);
+            } else {
+                readBytes += getChunkSize(table.dataPtr() + 8*n);
+            }
+        }
+        if(skipBytes > 0) {
+            is.seekg(skipBytes, std::ios::cur);
+        }
+        Vector<char> chunks(readBytes);
+        is.read(chunks.dataPtr(), readBytes);
+        if( ! is.good()) {
+            amrex::Error("VisMF: read of compressed FAB failed");
+        }
+
+        const std::size_t npts(fab.box().numPts());
+        const char *p = chunks.dataPtr();
+        for(int n(nlo); n < nhi; ++n) {
+            const std::int64_t nbytes(getChunkSize(table.dataPtr() + 8*n));
+            FabCompress::Decode(p, nbytes, fab.dataPtr(n - nlo), npts);
+            p += nbytes;
+        }
+    }
+
+    //
+    // A binary header starts with BinaryHeaderMagic and its own size in
+    // bytes.  The scalars, the names of the data files and an index
+    // follow.  The index has the offset of each array of fixed-size
+    // records: the boxes, the FabOnDisk entries as a file number and an
+    // offset, and the min and max of each FAB.  Integers are little-endian
+    // and Reals are little-endian doubles.  Parsing it is a copy, where the
+    // text header of a FabArray with many boxes takes seconds to parse.
+    //
+    const char BinaryHeaderMagic[] = "VisMF binary header\n";
+    constexpr std::size_t BinaryHeaderMagicSize = sizeof(BinaryHeaderMagic) - 1;
+    constexpr std::int32_t BinaryHeaderFormat = 1;
+
+    enum BinarySection { BinaryBoxes = 0, BinaryFabOnDisk, BinaryMin, BinaryMax,
+                         BinaryFAMin, BinaryFAMax, BinaryNSections };
+
+    template <class T>
+    void putBinary (Vector<char> &out, T v)
+    {
+        using U = typename std::make_unsigned<T>::type;
+        const U u(v);
+        for(int b(0); b < static_cast<int>(sizeof(T)); ++b) {
+            out.push_back(static_cast<char>((u >> (8*b)) & 0xff));
+        }
+    }
+
+    void putBinary (Vector<char> &out, double v)
+    {
+        std::uint64_t u;
+        std::memcpy(&u, &v, sizeof(u));
+        putBinary(out, u);
+    }
+
+    void putBinary (Vector<char> &out, const std::string &str)
+    {
+        putBinary(out, static_cast<std::int32_t>(str.size()));
+        out.insert(out.end(), str.begin(), str.end());
+    }
+
+    class BinaryHeaderReader
+    {
+    public:
+        BinaryHeaderReader (const char *buf, std::size_t nbytes)
+            : m_buf(buf), m_size(nbytes), m_pos(0) {}
+
+        template <class T>
+        T get ()
+        {
+            using U = typename std::make_unsigned<T>::type;
+            check(sizeof(T));
+            U u(0);
+            for(int b(0); b < static_cast<int>(sizeof(T)); ++b) {
+                u |= static_cast<U>(static_cast<unsigned char>(m_buf[m_pos + b])) << (8*b);
+            }
+            m_pos += sizeof(T);
+            return static_cast<T>(u);
+        }
+
+        Real getReal ()
+        {
+            const std::uint64_t u(get<std::uint64_t>());
+            double d;
+            std::memcpy(&d, &u, sizeof(d));
+            return static_cast<Real>(d);
+        }
+
+        std::string getString ()
+        {
+            const std::size_t n(get<std::int32_t>());
+            check(n);
+            std::string str(m_buf + m_pos, n);
+            m_pos += n;
+            return str;
+        }
+
+        void seek (std::size_t pos) { m_pos = pos; check(0); }
+
+    private:
+        void check (std::size_t n) const
+        {
+            if(m_pos + n > m_size) {
+                amrex::Error("VisMF::Header: binary header is truncated");
+            }
+        }
+
+        const char  *m_buf;
+        std::size_t  m_size;
+        std::size_t  m_pos;
+    };
+
+    bool HasFabMinMax (const VisMF::Header &hd)
+    {
+        return hd.m_vers == VisMF::Header::Version_v1           ||
+               hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
+               hd.m_vers == VisMF::Header::Compressed_v1;
+    }
+
+    /**
+    * \brief The format of the data as written in the header, or nothing if
+    * the header version has none.  A header that was read keeps its
+    * format, a new one has that of FArrayBox::getFormat().
+    */
+    std::string WrittenRD (const VisMF::Header &hd)
+    {
+        std::ostringstream os;
+        if(VisMF::Compressed(hd)) {
+            os << FPC::NativeRealDescriptor();    // ---- compressed data are never converted
+        } else if(VisMF::NoFabHeader(hd)) {
+            if( ! hd.m_writtenRD.formatarray().empty()) {
+                os << hd.m_writtenRD;
+            } else if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
+                os << FPC::NativeRealDescriptor();
+            } else if(FArrayBox::getFormat() == FABio::FAB_NATIVE_32) {
+                os << FPC::Native32RealDescriptor();
+            } else if(FArrayBox::getFormat() == FABio::FAB_IEEE_32) {
+                os << FPC::Ieee32NormalRealDescriptor();
+            }
+        }
+        return os.str();
+    }
+
+    void WriteBinaryHeader (const VisMF::Header &hd, Vector<char> &out)
+    {
+        out.clear();
+        out.insert(out.end(), BinaryHeaderMagic, BinaryHeaderMagic + BinaryHeaderMagicSize);
+        putBinary(out, std::int64_t(0));  // ---- the size, set at the end
+        putBinary(out, BinaryHeaderFormat);
+        putBinary(out, std::int32_t(hd.m_vers));
+        putBinary(out, std::int32_t(hd.m_how));
+        putBinary(out, std::int32_t(hd.m_ncomp));
+        putBinary(out, std::int32_t(AMREX_SPACEDIM));
+        const IntVect itype(hd.m_ba.ixType().ixType());
+        for(int idim(0); idim < AMREX_SPACEDIM; ++idim) {
+            putBinary(out, std::int32_t(hd.m_ngrow[idim]));
+            putBinary(out, std::int32_t(itype[idim]));
+        }
+        const long nboxes(hd.m_ba.size());
+        putBinary(out, std::int64_t(nboxes));
+
+        std::map<std::string, std::int32_t> fileNumber;
+        Vector<std::string> fileNames;
+        for(const auto &fod : hd.m_fod) {
+            if(fileNumber.emplace(fod.m_name, fileNames.size()).second) {
+                fileNames.push_back(fod.m_name);
+            }
+        }
+        putBinary(out, std::int32_t(fileNames.size()));
+        for(const auto &name : fileNames) {
+            putBinary(out, name);
+        }
+
+        putBinary(out, WrittenRD(hd));
+        putBinary(out, std::int32_t(hd.m_tol.size()));
+        for(Real tol : hd.m_tol) {
+            putBinary(out, double(tol));
+        }
+
+        const std::size_t indexStart(out.size());
+        out.resize(indexStart + 8*BinaryNSections, 0);
+        while(out.size() % 8 != 0) {
+            out.push_back(0);
+        }
+        auto beginSection = [&] (int section) {
+            putChunkSize(out.size(), out.dataPtr() + indexStart + 8*section);
+        };
+
+        beginSection(BinaryBoxes);
+        for(long i(0); i < nboxes; ++i) {
+            const Box &b = hd.m_ba[i];
+            for(int idim(0); idim < AMREX_SPACEDIM; ++idim) {
+                putBinary(out, std::int32_t(b.smallEnd(idim)));
+            }
+            for(int idim(0); idim < AMREX_SPACEDIM; ++idim) {
+                putBinary(out, std::int32_t(b.bigEnd(idim)));
+            }
+        }
+
+        beginSection(BinaryFabOnDisk);
+        for(const auto &fod : hd.m_fod) {
+            putBinary(out, fileNumber[fod.m_name]);
+            putBinary(out, std::int32_t(0));
+            putBinary(out, std::int64_t(fod.m_head));
+        }
+
+        if(HasFabMinMax(hd)) {
+            beginSection(BinaryMin);
+            for(const auto &v : hd.m_min) {
+                for(Real x : v) { putBinary(out, double(x)); }
+            }
+            beginSection(BinaryMax);
+            for(const auto &v : hd.m_max) {
+                for(Real x : v) { putBinary(out, double(x)); }
+            }
+        }
+        if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
+            beginSection(BinaryFAMin);
+            for(Real x : hd.m_famin) { putBinary(out, double(x)); }
+            beginSection(BinaryFAMax);
+            for(Real x : hd.m_famax) { putBinary(out, double(x)); }
+        }
+
+        putChunkSize(out.size(), out.dataPtr() + BinaryHeaderMagicSize);
+    }
+
+    void ReadBinaryHeader (const char *buf, VisMF::Header &hd)
+    {
+        const std::size_t nbytes(getChunkSize(buf + BinaryHeaderMagicSize));
+        BinaryHeaderReader r(buf, nbytes);
+        r.seek(BinaryHeaderMagicSize + 8);
+
+        if(r.get<std::int32_t>() != BinaryHeaderFormat) {
+            amrex::Error("VisMF::Header: unknown binary header format");
+        }
+        hd.m_vers = r.get<std::int32_t>();
+        BL_ASSERT(hd.m_vers != VisMF::Header::Undefined_v1);
+        const int how(r.get<std::int32_t>());
+        switch(how) {
+          case VisMF::OneFilePerCPU:
+            hd.m_how = VisMF::OneFilePerCPU;
+          break;
+          case VisMF::NFiles:
+            hd.m_how = VisMF::NFiles;
+          break;
+          default:
+            amrex::Error("Bad case in VisMF::Header.m_how switch");
+        }
+        hd.m_ncomp = r.get<std::int32_t>();
+        BL_ASSERT(hd.m_ncomp >= 0);
+
+        const int ndims(r.get<std::int32_t>());
+        if(ndims > AMREX_SPACEDIM) {
+            amrex::Error("VisMF::Header: binary header has more dimensions than AMREX_SPACEDIM");
+        }
+        IntVect itype(IntVect::TheZeroVector());
+        hd.m_ngrow = IntVect::TheZeroVector();
+        for(int idim(0); idim < ndims; ++idim) {
+            hd.m_ngrow[idim] = r.get<std::int32_t>();
+            itype[idim] = r.get<std::int32_t>();
+        }
+        const long nboxes(r.get<std::int64_t>());
+
+        Vector<std::string> fileNames(r.get<std::int32_t>());
+        for(auto &name : fileNames) {
+            name = r.getString();
+        }
+
+        const std::string rd(r.getString());
+        if( ! rd.empty()) {
+            std::istringstream is(rd);
+            is >> hd.m_writtenRD;
+        }
+        hd.m_tol.resize(r.get<std::int32_t>());
+        for(auto &tol : hd.m_tol) {
+            tol = r.getReal();
+        }
+        if(hd.m_vers == VisMF::Header::Compressed_v1 &&
+           hd.m_writtenRD.numBytes() != sizeof(Real))
+        {
+            amrex::Error("VisMF::Header: compressed data were written with a different Real type");
+        }
+
+        std::array<std::size_t, BinaryNSections> index;
+        for(auto &offset : index) {
+            offset = r.get<std::int64_t>();
+        }
+
+        const IndexType ixtype(itype);
+        Vector<Box> boxes(nboxes);
+        r.seek(index[BinaryBoxes]);
+        for(auto &b : boxes) {
+            IntVect lo(IntVect::TheZeroVector()), hi(IntVect::TheZeroVector());
+            for(int idim(0); idim < ndims; ++idim) {
+                lo[idim] = r.get<std::int32_t>();
+            }
+            for(int idim(0); idim < ndims; ++idim) {
+                hi[idim] = r.get<std::int32_t>();
+            }
+            b = Box(lo, hi, ixtype);
+        }
+        hd.m_ba = BoxArray(BoxList(std::move(boxes)));
+
+        hd.m_fod.resize(nboxes);
+        r.seek(index[BinaryFabOnDisk]);
+        for(auto &fod : hd.m_fod) {
+            const int ifile(r.get<std::int32_t>());
+            r.get<std::int32_t>();
+            if(ifile < 0 || ifile >= static_cast<int>(fileNames.size())) {
+                amrex::Error("VisMF::Header: bad file number in binary header");
+            }
+            fod.m_name = fileNames[ifile];
+            fod.m_head = r.get<std::int64_t>();
+        }
+
+        if(HasFabMinMax(hd)) {
+            hd.m_min.resize(nboxes);
+            hd.m_max.resize(nboxes);
+            r.seek(index[BinaryMin]);
+            for(auto &v : hd.m_min) {
+                v.resize(hd.m_ncomp);
+                for(auto &x : v) { x = r.getReal(); }
+            }
+            r.seek(index[BinaryMax]);
+            for(auto &v : hd.m_max) {
+                v.resize(hd.m_ncomp);
+                for(auto &x : v) { x = r.getReal(); }
+            }
+
+            // ---- the min and max of the FabArray follow from those of the FABs
+            hd.m_famin.assign(hd.m_ncomp,  std::numeric_limits<Real>::max());
+            hd.m_famax.assign(hd.m_ncomp, -std::numeric_limits<Real>::max());
+            for(long ibox(0); ibox < nboxes; ++ibox) {
+                for(int comp(0); comp < hd.m_ncomp; ++comp) {
+                    hd.m_famin[comp] = std::min(hd.m_famin[comp], hd.m_min[ibox][comp]);
+                    hd.m_famax[comp] = std::max(hd.m_famax[comp], hd.m_max[ibox][comp]);
+                }
+            }
+        }
+        if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
+            hd.m_famin.resize(hd.m_ncomp);
+            hd.m_famax.resize(hd.m_ncomp);
+            r.seek(index[BinaryFAMin]);
+            for(auto &x : hd.m_famin) { x = r.getReal(); }
+            r.seek(index[BinaryFAMax]);
+            for(auto &x : hd.m_famax) { x = r.getReal(); }
+        }
+    }
+
+    //! Parse a header read into memory, in either format.
+    void ParseHeader (const char *buf, VisMF::Header &hdr)
+    {
+        if(std::strncmp(buf, BinaryHeaderMagic, BinaryHeaderMagicSize) == 0) {
+            ReadBinaryHeader(buf, hdr);
+        } else {
+            std::istringstream infs(std::string(buf), std::istringstream::in);
+            infs >> hdr;
+        }
+    }
+
+    //! The format of the data of the FABs in memory.
+    const RealDescriptor& NativeFabRD (const FabArray<FArrayBox> &)
+    {
+        return FPC::NativeRealDescriptor();
+    }
+
+    const RealDescriptor& NativeFabRD (const FabArray<BaseFab<float> > &)
+    {
+        return FPC::Native32RealDescriptor();
+    }
+
+    //! The FAB header written in front of the data with Version_v1.
+    std::string FabHeader (const FArrayBox &fab)
+    {
+        std::stringstream hss;
+        FArrayBox::getFABio().write_header(hss, fab, fab.nComp());
+        return hss.str();
+    }
+
+    std::string FabHeader (const BaseFab<float> &)
+    {
+        amrex::Abort("VisMF::Write:  single precision FABs are written without FAB headers");
+        return std::string();
+    }
+
+    //! Convert nitems values of fab to format rd.
+    void ConvertFabData (void *out, const FArrayBox &fab, long nitems, const RealDescriptor &rd)
+    {
+        RealDescriptor::convertFromNativeFormat(out, nitems, fab.dataPtr(), rd);
+    }
+
+    void ConvertFabData (void *out, const BaseFab<float> &fab, long nitems, const RealDescriptor &rd)
+    {
+        Vector<Real> tmp(fab.dataPtr(), fab.dataPtr() + nitems);
+        RealDescriptor::convertFromNativeFormat(out, nitems, tmp.dataPtr(), rd);
+    }
+
+    long EncodeFab (const BaseFab<float> &, Vector<char> &, const Vector<Real> &)
+    {
+        amrex::Abort("VisMF::Write:  single precision FABs cannot be compressed");
+        return 0;
+    }
+
+    //! The bytes of the FABs of this process, with FAB headers if fabHeaders.
+    template <class FAB>
+    long FabsBytes (const FabArray<FAB> &mf, const RealDescriptor &rd, bool fabHeaders)
+    {
+        long nbytes(0);
+        for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            const FAB &fab = mf[mfi];
+            if(fabHeaders) {
+                nbytes += FabHeader(fab).size();
+            }
+            nbytes += fab.box().numPts() * mf.nComp() * rd.numBytes();
+        }
+        return nbytes;
+    }
+
+    //! Copy the FABs of this process to buf as they are written to the file.
+    template <class FAB>
+    void CopyFabsToBuffer (const FabArray<FAB> &mf, const RealDescriptor &rd,
+                           bool doConvert, bool fabHeaders, char *buf)
+    {
+        long writePosition(0);
+        for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            long hLength(0);
+            const FAB &fab = mf[mfi];
+            const long writeDataItems(fab.box().numPts() * mf.nComp());
+            const long writeDataSize(writeDataItems * rd.numBytes());
+            char *afPtr = buf + writePosition;
+            if(fabHeaders) {
+                const std::string fabHeader(FabHeader(fab));
+                hLength = fabHeader.size();
+                std::memcpy(afPtr, fabHeader.c_str(), hLength);  // ---- the fab header
+            }
+            if(doConvert) {
+                ConvertFabData(afPtr + hLength, fab, writeDataItems, rd);
+            } else {    // ---- copy from the fab
+                std::memcpy(afPtr + hLength, fab.dataPtr(), writeDataSize);
+            }
+            writePosition += hLength + writeDataSize;
+        }
+    }
+
+    /**
+    * \brief A DistributionMapping of the boxes on disk that gives each box to
+    * the process owning most of its cells in mf.  Boxes outside mf go round
+    * robin.
+    */
+    DistributionMapping OwnerDistributionMap (const BoxArray &diskba,
+                                              const FabArrayBase &mf)
+    {
+        const BoxArray &ba = mf.boxArray();
+        const DistributionMapping &dm = mf.DistributionMap();
+        const int nprocs(ParallelDescriptor::NProcs());
+        Vector<int> pmap(diskba.size());
+        std::map<int,long> cells;  // ---- [proc, cells]
+        for(int i(0); i < diskba.size(); ++i) {
+            cells.clear();
+            for(const auto &isect : ba.intersections(diskba[i])) {
+                cells[dm[isect.first]] += isect.second.numPts();
+            }
+            pmap[i] = i % nprocs;
+            long maxcells(0);
+            for(const auto &pc : cells) {
+                if(pc.second > maxcells) {
+                    maxcells = pc.second;
+                    pmap[i] = pc.first;
+                }
+            }
+        }
+        return DistributionMapping(std::move(pmap));
+    }
 }
 
 void
@@ -83,9 +629,14 @@ VisMF::Initialize ()
     pp.query("checkfilepositions", checkFilePositions);
     pp.query("usepersistentifstreams", usePersistentIFStreams);
     pp.query("usesynchronousreads", useSynchronousReads);
+    pp.query("usedirectreads", useDirectReads);
     pp.query("usedynamicsetselection", useDynamicSetSelection);
     pp.query("iobuffersize", ioBufferSize);
     pp.query("allowsparsewrites", allowSparseWrites);
+    pp.query("usemmap", useMmap);
+    pp.query("binaryheader", binaryHeader);
+    pp.query("aggregatewrites", aggregateWrites);
+    pp.query("aggregatorranks", aggregatorRanks);
 
     initialized = true;
 }
@@ -283,8 +834,9 @@ operator<< (std::ostream        &os,
 
     os << hd.m_fod      << '\n';
 
-    if(hd.m_vers == VisMF::Header::Version_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1)
+    if(hd.m_vers == VisMF::Header::Version_v1           ||
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       os << hd.m_min      << '\n';
       os << hd.m_max      << '\n';
@@ -303,17 +855,15 @@ operator<< (std::ostream        &os,
       os << '\n';
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
-    {
-      if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
-        os << FPC::NativeRealDescriptor() << '\n';
-      } else if(FArrayBox::getFormat() == FABio::FAB_NATIVE_32) {
-        os << FPC::Native32RealDescriptor() << '\n';
-      } else if(FArrayBox::getFormat() == FABio::FAB_IEEE_32) {
-        os << FPC::Ieee32NormalRealDescriptor() << '\n';
+    const std::string rd(WrittenRD(hd));
+    if( ! rd.empty()) {
+      os << rd << '\n';
+    }
+    if(hd.m_vers == VisMF::Header::Compressed_v1) {
+      for(int i(0); i < hd.m_ncomp; ++i) {
+        os << (i < hd.m_tol.size() ? hd.m_tol[i] : 0.0) << ',';
       }
+      os << '\n';
     }
 
     os.flags(oflags);
@@ -367,13 +917,24 @@ operator>> (std::istream  &is,
     is >> hd.m_fod;
     BL_ASSERT(hd.m_ba.size() == hd.m_fod.size());
 
-    if(hd.m_vers == VisMF::Header::Version_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1)
+    if(hd.m_vers == VisMF::Header::Version_v1           ||
+       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       is >> hd.m_min;
       is >> hd.m_max;
       BL_ASSERT(hd.m_ba.size() == hd.m_min.size());
       BL_ASSERT(hd.m_ba.size() == hd.m_max.size());
+
+      // ---- the min and max of the FabArray follow from those of the FABs
+      hd.m_famin.assign(hd.m_ncomp,  std::numeric_limits<Real>::max());
+      hd.m_famax.assign(hd.m_ncomp, -std::numeric_limits<Real>::max());
+      for(int ibox(0); ibox < hd.m_min.size(); ++ibox) {
+        for(int comp(0); comp < hd.m_min[ibox].size(); ++comp) {
+          hd.m_famin[comp] = std::min(hd.m_famin[comp], hd.m_min[ibox][comp]);
+          hd.m_famax[comp] = std::max(hd.m_famax[comp], hd.m_max[ibox][comp]);
+        }
+      }
     }
 
     if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
@@ -395,10 +956,26 @@ operator>> (std::istream  &is,
     }
     if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
        hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::Compressed_v1)
     {
       is >> hd.m_writtenRD;
     }
+    if(hd.m_vers == VisMF::Header::Compressed_v1 &&
+       hd.m_writtenRD.numBytes() != sizeof(Real))
+    {
+      amrex::Error("VisMF::Header: compressed data were written with a different Real type");
+    }
+    if(hd.m_vers == VisMF::Header::Compressed_v1) {
+      char ch;
+      hd.m_tol.resize(hd.m_ncomp);
+      for(int i(0); i < hd.m_tol.size(); ++i) {
+        is >> hd.m_tol[i] >> ch;
+	if( ch != ',' ) {
+	  amrex::Error("Expected a ',' when reading hd.m_tol");
+	}
+      }
+    }
 
 
     if( ! is.good()) {
@@ -519,12 +1096,128 @@ const FArrayBox&
 VisMF::GetFab (int fabIndex,
                int ncomp) const
 {
+    if(m_pa[ncomp][fabIndex] == 0 && useMmap) {
+        m_pa[ncomp][fabIndex] = mapFAB(fabIndex, ncomp);
+    }
     if(m_pa[ncomp][fabIndex] == 0) {
         m_pa[ncomp][fabIndex] = VisMF::readFAB(fabIndex, m_fafabname, m_hdr, ncomp);
     }
     return *m_pa[ncomp][fabIndex];
 }
 
+
+struct VisMF::MappedFile
+{
+    explicit MappedFile (const std::string &fileName)
+    {
+#if defined(__linux__) || defined(__APPLE__)
+        int fd(::open(fileName.c_str(), O_RDONLY));
+        if(fd < 0) {
+          return;
+        }
+        struct stat sb;
+        if(::fstat(fd, &sb) == 0 && sb.st_size > 0) {
+          void *p = ::mmap(nullptr, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+          if(p != MAP_FAILED) {
+            m_data = static_cast<const char *>(p);
+            m_size = sb.st_size;
+          }
+        }
+        ::close(fd);   // ---- the mapping stays valid
+#else
+        amrex::ignore_unused(fileName);
+#endif
+    }
+
+    ~MappedFile ()
+    {
+#if defined(__linux__) || defined(__APPLE__)
+        if(m_data != nullptr) {
+          ::munmap(const_cast<char *>(m_data), m_size);
+        }
+#endif
+    }
+
+    MappedFile (const MappedFile&) = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+
+    const char  *m_data = nullptr;
+    std::size_t  m_size = 0;
+};
+
+
+FArrayBox *
+VisMF::mapFAB (int idx, int whichComp) const
+{
+    if(Compressed(m_hdr)) {
+      return nullptr;    // ---- readFAB decodes only the one component
+    }
+
+    const std::string fileName(VisMF::DirName(m_fafabname) + m_hdr.m_fod[idx].m_name);
+    auto &mapped = m_mapped[fileName];
+    if( ! mapped) {
+      mapped.reset(new MappedFile(fileName));
+    }
+    if(mapped->m_data == nullptr) {
+      return nullptr;
+    }
+
+    Box fab_box(amrex::grow(m_hdr.m_ba[idx], m_hdr.m_ngrow));
+    std::size_t start(m_hdr.m_fod[idx].m_head);
+    RealDescriptor rd(m_hdr.m_writtenRD);
+
+    if(m_hdr.m_vers == Header::Version_v1) {
+      //
+      // Only the binary FAB header, a single line, can be parsed here.
+      //
+      const std::size_t maxHeaderLength(1024);
+      if(start >= mapped->m_size) {
+        return nullptr;
+      }
+      const char *hbeg = mapped->m_data + start;
+      const char *hend = static_cast<const char *>(
+          std::memchr(hbeg, '\n', std::min(maxHeaderLength, mapped->m_size - start)));
+      if(hend == nullptr) {
+        return nullptr;
+      }
+      std::istringstream is(std::string(hbeg, hend));
+      char f, a, b, c;
+      int nvar;
+      is >> f >> a >> b >> c;
+      if(f != 'F' || a != 'A' || b != 'B' || c != '(') {
+        return nullptr;
+      }
+      is.putback(c);
+      is >> rd >> fab_box >> nvar;
+      if(is.fail() || nvar != m_hdr.m_ncomp) {
+        return nullptr;
+      }
+      start += (hend - hbeg) + 1;
+    } else if( ! NoFabHeader(m_hdr)) {
+      return nullptr;
+    }
+
+    const long npts(fab_box.numPts());
+    const std::size_t compBytes(npts * rd.numBytes());
+    start += whichComp * compBytes;
+    if(start + compBytes > mapped->m_size) {
+      amrex::Error("VisMF::mapFAB: data file too small " + fileName);
+    }
+    const char *p = mapped->m_data + start;
+
+    if(rd == FPC::NativeRealDescriptor()) {
+      if(reinterpret_cast<std::uintptr_t>(p) % alignof(Real) == 0) {
+        return new FArrayBox(fab_box, 1, reinterpret_cast<Real const *>(p));
+      }
+      FArrayBox *fab = new FArrayBox(fab_box, 1);
+      std::memcpy(fab->dataPtr(), p, compBytes);
+      return fab;
+    }
+    FArrayBox *fab = new FArrayBox(fab_box, 1);
+    RealDescriptor::convertToNativeFormat(fab->dataPtr(), npts, const_cast<char *>(p), rd);
+    return fab;
+}
+
 void
 VisMF::clear (int fabIndex,
               int compIndex)
@@ -646,7 +1339,8 @@ VisMF::Header::Header ()
 // The more-or-less complete header only exists at IOProcessor().
 //
 
-VisMF::Header::Header (const FabArray<FArrayBox>& mf,
+template <class FAB>
+VisMF::Header::Header (const FabArray<FAB>& mf,
                        VisMF::How how,
 		       Version version,
 		       bool calcMinMax,
@@ -679,8 +1373,8 @@ VisMF::Header::Header (const FabArray<FArrayBox>& mf,
       for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
         const int idx = mfi.index();
         for(int i(0); i < m_ncomp; ++i) {
-          m_famin[i] = std::min(m_famin[i], mf[mfi].min(m_ba[idx],i));
-          m_famax[i] = std::max(m_famax[i], mf[mfi].max(m_ba[idx],i));
+          m_famin[i] = std::min(m_famin[i], Real(mf[mfi].min(m_ba[idx],i)));
+          m_famax[i] = std::max(m_famax[i], Real(mf[mfi].max(m_ba[idx],i)));
         }
       }
       ParallelAllReduce::Min(m_famin.dataPtr(), m_famin.size(), comm);
@@ -694,8 +1388,12 @@ VisMF::Header::Header (const FabArray<FArrayBox>& mf,
     }
 }
 
+template VisMF::Header::Header (const FabArray<FArrayBox>&, VisMF::How, Version, bool, MPI_Comm);
+template VisMF::Header::Header (const FabArray<BaseFab<float> >&, VisMF::How, Version, bool, MPI_Comm);
+
+template <class FAB>
 void
-VisMF::Header::CalculateMinMax (const FabArray<FArrayBox>& mf,
+VisMF::Header::CalculateMinMax (const FabArray<FAB>& mf,
                                 int procToWrite, MPI_Comm comm)
 {
 //    BL_PROFILE("VisMF::CalculateMinMax");
@@ -855,6 +1553,9 @@ VisMF::Header::CalculateMinMax (const FabArray<FArrayBox>& mf,
     }
 }
 
+template void VisMF::Header::CalculateMinMax (const FabArray<FArrayBox>&, int, MPI_Comm);
+template void VisMF::Header::CalculateMinMax (const FabArray<BaseFab<float> >&, int, MPI_Comm);
+
 long
 VisMF::WriteHeaderDoit (const std::string&mf_name, const VisMF::Header& hdr)
 {
@@ -868,13 +1569,23 @@ VisMF::WriteHeaderDoit (const std::string&mf_name, const VisMF::Header& hdr)
 
     MFHdrFile.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
 
-    MFHdrFile.open(MFHdrFileName.c_str(), std::ios::out | std::ios::trunc);
+    std::ios::openmode mode(std::ios::out | std::ios::trunc);
+    if(binaryHeader) {
+        mode |= std::ios::binary;
+    }
+    MFHdrFile.open(MFHdrFileName.c_str(), mode);
 
     if( ! MFHdrFile.good()) {
         amrex::FileOpenFailed(MFHdrFileName);
     }
 
-    MFHdrFile << hdr;
+    if(binaryHeader) {
+        Vector<char> buf;
+        WriteBinaryHeader(hdr, buf);
+        MFHdrFile.write(buf.dataPtr(), buf.size());
+    } else {
+        MFHdrFile << hdr;
+    }
 
     //
     // Add in the number of bytes written out in the Header.
@@ -898,7 +1609,7 @@ VisMF::WriteHeader (const std::string &mf_name, VisMF::Header &hdr,
 
         bytesWritten += WriteHeaderDoit(mf_name, hdr);
 
-	if(checkFilePositions) {
+	if(checkFilePositions && ! binaryHeader) {
           std::stringstream hss;
 	  hss << hdr;
 	  if(static_cast<std::streamoff>(hss.tellp()) != bytesWritten) {
@@ -916,7 +1627,8 @@ long
 VisMF::Write (const FabArray<FArrayBox>&    mf,
               const std::string& mf_name,
               VisMF::How         how,
-              bool               set_ghost)
+              bool               set_ghost,
+              const Vector<Real>& tolerance)
 {
     BL_PROFILE("VisMF::Write(FabArray)");
     BL_ASSERT(mf_name[mf_name.length() - 1] != '/');
@@ -924,17 +1636,17 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 
     // ---- add stream retry
     // ---- add stream buffer (to nfiles)
-    RealDescriptor *whichRD = nullptr;
-    if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
-      whichRD = FPC::NativeRealDescriptor().clone();
+    const bool compressed(currentVersion == VisMF::Header::Compressed_v1);
+    const RealDescriptor *whichRD = nullptr;
+    if(compressed || FArrayBox::getFormat() == FABio::FAB_NATIVE) {
+      whichRD = &FPC::NativeRealDescriptor();
     } else if(FArrayBox::getFormat() == FABio::FAB_NATIVE_32) {
-      whichRD = FPC::Native32RealDescriptor().clone();
+      whichRD = &FPC::Native32RealDescriptor();
     } else if(FArrayBox::getFormat() == FABio::FAB_IEEE_32) {
-      whichRD = FPC::Ieee32NormalRealDescriptor().clone();
+      whichRD = &FPC::Ieee32NormalRealDescriptor();
     } else {
       Abort("VisMF::Write unable to execute with the current fab.format setting.  Use NATIVE, NATIVE_32 or IEEE_32");
     }
-    bool doConvert(*whichRD != FPC::NativeRealDescriptor());
 
     if(set_ghost) {
         FabArray<FArrayBox>* the_mf = const_cast<FabArray<FArrayBox>*>(&mf);
@@ -952,6 +1664,43 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
         }
     }
 
+    return WriteDoit(mf, mf_name, how, currentVersion, *whichRD, tolerance);
+}
+
+
+long
+VisMF::Write (const FabArray<BaseFab<float> >& mf,
+              const std::string& mf_name,
+              VisMF::How         how)
+{
+    BL_PROFILE("VisMF::Write(FabArray<float>)");
+    BL_ASSERT(mf_name[mf_name.length() - 1] != '/');
+    BL_ASSERT(currentVersion != VisMF::Header::Undefined_v1);
+
+    //
+    // The data are written as they are, without FAB headers.
+    //
+    const VisMF::Header::Version whichVersion((currentVersion == VisMF::Header::Version_v1 ||
+                                               currentVersion == VisMF::Header::Compressed_v1)
+                                              ? VisMF::Header::NoFabHeaderMinMax_v1
+                                              : currentVersion);
+
+    return WriteDoit(mf, mf_name, how, whichVersion, FPC::Native32RealDescriptor());
+}
+
+
+template <class FAB>
+long
+VisMF::WriteDoit (const FabArray<FAB>& mf,
+                  const std::string& mf_name,
+                  VisMF::How         how,
+                  VisMF::Header::Version whichVersion,
+                  const RealDescriptor& whichRD,
+                  const Vector<Real>& tolerance)
+{
+    const bool compressed(whichVersion == VisMF::Header::Compressed_v1);
+    const bool doConvert(whichRD != NativeFabRD(mf));
+
     // ---- check if mf has sparse data
     bool useSparseFPP(false);
     const Vector<int> &pmap = mf.DistributionMap().ProcessorMap();
@@ -960,7 +1709,7 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     for(int i(0); i < pmap.size(); ++i) {
       procsWithData.insert(pmap[i]);
     }
-    if(allowSparseWrites && (procsWithData.size() < nOutFiles)) {
+    if(allowSparseWrites && (static_cast<int>(procsWithData.size()) < nOutFiles)) {
       useSparseFPP = true;
 //      amrex::Print() << "SSSSSSSS:  in VisMF::Write:  useSparseFPP for:  " << mf_name << '\n';
       for(std::set<int>::iterator it = procsWithData.begin(); it != procsWithData.end(); ++it) {
@@ -971,34 +1720,60 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     int coordinatorProc(ParallelDescriptor::IOProcessorNumber());
     long bytesWritten(0);
     bool calcMinMax(false);
-    VisMF::Header hdr(mf, how, currentVersion, calcMinMax);
+    VisMF::Header hdr(mf, how, whichVersion, calcMinMax);
+    // ---- the header and FindOffsets take the format from here, not from FArrayBox
+    hdr.m_writtenRD = whichRD;
+    if(compressed) {
+      hdr.m_tol.resize(mf.nComp(), 0.0);
+      for(int i(0); i < std::min<int>(mf.nComp(), tolerance.size()); ++i) {
+        hdr.m_tol[i] = std::max(tolerance[i], Real(0.0));
+      }
+    }
 
     std::string filePrefix(mf_name + FabFileSuffix);
 
     NFilesIter nfi(nOutFiles, filePrefix, groupSets, setBuf);
 
-    bool oldHeader(currentVersion == VisMF::Header::Version_v1);
+    bool oldHeader(whichVersion == VisMF::Header::Version_v1);
+
+    // ---- compress before waiting for a turn to write
+    Vector<char> compressedData;
+    Vector<long> fabBytes;
+    if(compressed) {
+      fabBytes.resize(mf.size(), 0);
+      for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        fabBytes[mfi.index()] = EncodeFab(mf[mfi], compressedData, hdr.m_tol);
+      }
+    }
 
+    if(aggregateWrites && ! useSparseFPP) {
+      if(compressed) {
+        nfi.WriteAggregated(compressedData.dataPtr(), compressedData.size(), aggregatorRanks);
+        bytesWritten += compressedData.size();
+      } else {
+        const long nBytes(FabsBytes(mf, whichRD, oldHeader));
+        std::unique_ptr<char[]> allFabData(new char[std::max(nBytes, 1L)]);
+        CopyFabsToBuffer(mf, whichRD, doConvert, oldHeader, allFabData.get());
+        nfi.WriteAggregated(allFabData.get(), nBytes, aggregatorRanks);
+        bytesWritten += nBytes;
+      }
+    } else {
       if(useSparseFPP) {
         nfi.SetSparseFPP(procsWithDataVector);
       } else if(useDynamicSetSelection) {
         nfi.SetDynamic();
       }
       for( ; nfi.ReadyToWrite(); ++nfi) {
+          if(compressed) {
+            nfi.Stream().write(compressedData.dataPtr(), compressedData.size());
+            nfi.Stream().flush();
+            bytesWritten += compressedData.size();
+            continue;
+          }
 	  // ---- find the total number of bytes including fab headers if needed
-          const FABio &fio = FArrayBox::getFABio();
-          int whichRDBytes(whichRD->numBytes()), nFABs(0);
+          int whichRDBytes(whichRD.numBytes()), nFABs(mf.local_size());
           long writeDataItems(0), writeDataSize(0);
-          for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
-	    const FArrayBox &fab = mf[mfi];
-	    if(oldHeader) {
-	      std::stringstream hss;
-	      fio.write_header(hss, fab, fab.nComp());
-	      bytesWritten += static_cast<std::streamoff>(hss.tellp());
-	    }
-	    bytesWritten += fab.box().numPts() * mf.nComp() * whichRDBytes;
-	    ++nFABs;
-	  }
+          bytesWritten += FabsBytes(mf, whichRD, oldHeader);
 	  char *allFabData(nullptr);
 	  bool canCombineFABs(false);
 	  if((nFABs > 1 || doConvert) && VisMF::useSingleWrite) {
@@ -1011,84 +1786,65 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 	  }
 
 	  if(canCombineFABs) {
-            long writePosition(0);
-            for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
-              int hLength(0);
-              const FArrayBox &fab = mf[mfi];
-	      writeDataItems = fab.box().numPts() * mf.nComp();
-	      writeDataSize = writeDataItems * whichRDBytes;
-	      char *afPtr = allFabData + writePosition;
-	      if(oldHeader) {
-	        std::stringstream hss;
-	        fio.write_header(hss, fab, fab.nComp());
-	        hLength = static_cast<std::streamoff>(hss.tellp());
-                auto tstr = hss.str();
-	        memcpy(afPtr, tstr.c_str(), hLength);  // ---- the fab header
-	      }
-	      if(doConvert) {
-	        RealDescriptor::convertFromNativeFormat(static_cast<void *> (afPtr + hLength),
-		                                        writeDataItems,
-		                                        fab.dataPtr(), *whichRD);
-	      } else {    // ---- copy from the fab
-	        memcpy(afPtr + hLength, fab.dataPtr(), writeDataSize);
-	      }
-              writePosition += hLength + writeDataSize;
-            }
+            CopyFabsToBuffer(mf, whichRD, doConvert, oldHeader, allFabData);
             nfi.Stream().write(allFabData, bytesWritten);
             nfi.Stream().flush();
 	    delete [] allFabData;
 
 	  } else {    // ---- write fabs individually
             for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
-              int hLength(0);
-              const FArrayBox &fab = mf[mfi];
+              const FAB &fab = mf[mfi];
 	      writeDataItems = fab.box().numPts() * mf.nComp();
 	      writeDataSize = writeDataItems * whichRDBytes;
 	      if(oldHeader) {
-	        std::stringstream hss;
-	        fio.write_header(hss, fab, fab.nComp());
-	        hLength = static_cast<std::streamoff>(hss.tellp());
-                auto tstr = hss.str();
-                nfi.Stream().write(tstr.c_str(), hLength);    // ---- the fab header
+                const std::string fabHeader(FabHeader(fab));
+                nfi.Stream().write(fabHeader.c_str(), fabHeader.size());    // ---- the fab header
                 nfi.Stream().flush();
 	      }
 	      if(doConvert) {
 	        char *cDataPtr = new char[writeDataSize];
-	        RealDescriptor::convertFromNativeFormat(static_cast<void *> (cDataPtr),
-		                                        writeDataItems,
-		                                        fab.dataPtr(), *whichRD);
+                ConvertFabData(cDataPtr, fab, writeDataItems, whichRD);
                 nfi.Stream().write(cDataPtr, writeDataSize);
                 nfi.Stream().flush();
 	        delete [] cDataPtr;
 	      } else {    // ---- copy from the fab
-                nfi.Stream().write((char *) fab.dataPtr(), writeDataSize);
+                nfi.Stream().write((const char *) fab.dataPtr(), writeDataSize);
                 nfi.Stream().flush();
 	      }
             }
 	  }
       }
+    }
 
 
     if(nfi.GetDynamic()) {
       coordinatorProc = nfi.CoordinatorProc();
     }
 
-    if(currentVersion == VisMF::Header::Version_v1 ||
-       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1)
+    if(whichVersion == VisMF::Header::Version_v1           ||
+       whichVersion == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       whichVersion == VisMF::Header::Compressed_v1)
     {
       hdr.CalculateMinMax(mf, coordinatorProc);
     }
 
-    VisMF::FindOffsets(mf, filePrefix, hdr, groupSets, currentVersion, nfi,
-                       ParallelDescriptor::Communicator());
+    if(compressed && fabBytes.size() > 0) {
+      ParallelDescriptor::ReduceLongSum(fabBytes.dataPtr(), fabBytes.size(), coordinatorProc);
+    }
 
-    bytesWritten += VisMF::WriteHeader(mf_name, hdr, coordinatorProc);
+    VisMF::FindOffsets(mf, filePrefix, hdr, groupSets, whichVersion, nfi,
+                       ParallelDescriptor::Communicator(), fabBytes);
 
-    delete whichRD;
+    bytesWritten += VisMF::WriteHeader(mf_name, hdr, coordinatorProc);
 
     return bytesWritten;
 }
 
+template long VisMF::WriteDoit (const FabArray<FArrayBox>&, const std::string&, VisMF::How,
+                                VisMF::Header::Version, const RealDescriptor&, const Vector<Real>&);
+template long VisMF::WriteDoit (const FabArray<BaseFab<float> >&, const std::string&, VisMF::How,
+                                VisMF::Header::Version, const RealDescriptor&, const Vector<Real>&);
+
 
 long
 VisMF::WriteOnlyHeader (const FabArray<FArrayBox> & mf,
@@ -1124,13 +1880,15 @@ VisMF::WriteOnlyHeader (const FabArray<FArrayBox> & mf,
 }
 
 
+template <class FAB>
 void
-VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
+VisMF::FindOffsets (const FabArray<FAB> &mf,
 		    const std::string &filePrefix,
                     VisMF::Header &hdr,
 		    bool groupSets,
 		    VisMF::Header::Version whichVersion,
-		    NFilesIter &nfi, MPI_Comm comm)
+		    NFilesIter &nfi, MPI_Comm comm,
+                    const Vector<long> &fabBytes)
 {
 //    BL_PROFILE("VisMF::FindOffsets");
 
@@ -1141,8 +1899,12 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
       coordinatorProc = nfi.CoordinatorProc();
     }
 
-    if(FArrayBox::getFormat() == FABio::FAB_ASCII ||
-       FArrayBox::getFormat() == FABio::FAB_8BIT)
+    const bool compressed(hdr.m_vers == VisMF::Header::Compressed_v1);
+    BL_ASSERT( ! compressed || fabBytes.size() == mf.size() || myProc != coordinatorProc);
+
+    if(( ! compressed) && hdr.m_writtenRD.formatarray().empty() &&
+       (FArrayBox::getFormat() == FABio::FAB_ASCII ||
+        FArrayBox::getFormat() == FABio::FAB_8BIT))
     {
 
 #ifdef BL_USE_MPI
@@ -1212,7 +1974,9 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
     } else {    // ---- calculate offsets
 
       RealDescriptor *whichRD = nullptr;
-      if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
+      if( ! hdr.m_writtenRD.formatarray().empty()) {
+        whichRD = hdr.m_writtenRD.clone();
+      } else if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
         whichRD = FPC::NativeRealDescriptor().clone();
       } else if(FArrayBox::getFormat() == FABio::FAB_NATIVE_32) {
         whichRD = FPC::Native32RealDescriptor().clone();
@@ -1220,7 +1984,7 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
         whichRD = FPC::Ieee32NormalRealDescriptor().clone();
       }
       const FABio &fio = FArrayBox::getFABio();
-      int whichRDBytes(whichRD->numBytes());
+      int whichRDBytes(compressed ? 0 : whichRD->numBytes());
       int nComps(mf.nComp());
 
       if(myProc == coordinatorProc) {   // ---- calculate offsets
@@ -1279,8 +2043,12 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 	      for(int i(0); i < index.size(); ++i) {
                  hdr.m_fod[index[i]].m_name = whichFileName;
                  hdr.m_fod[index[i]].m_head = currentOffset[whichFileNumber];
-                 currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
-	                                           + fabHeaderBytes[index[i]];
+                 if(compressed) {
+                   currentOffset[whichFileNumber] += fabBytes[index[i]];
+                 } else {
+                   currentOffset[whichFileNumber] += mf.fabbox(index[i]).numPts() * nComps * whichRDBytes
+	                                             + fabHeaderBytes[index[i]];
+                 }
               }
             }
 	  }
@@ -1291,6 +2059,14 @@ VisMF::FindOffsets (const FabArray<FArrayBox> &mf,
 }
 
 
+template void VisMF::FindOffsets (const FabArray<FArrayBox>&, const std::string&, VisMF::Header&,
+                                  bool, VisMF::Header::Version, NFilesIter&, MPI_Comm,
+                                  const Vector<long>&);
+template void VisMF::FindOffsets (const FabArray<BaseFab<float> >&, const std::string&, VisMF::Header&,
+                                  bool, VisMF::Header::Version, NFilesIter&, MPI_Comm,
+                                  const Vector<long>&);
+
+
 void
 VisMF::RemoveFiles(const std::string &mf_name, bool verbose)
 {
@@ -1333,10 +2109,7 @@ VisMF::VisMF (const std::string &fafab_name)
 
     Vector<char> fileCharPtr;
     ParallelDescriptor::ReadAndBcastFile(FullHdrFileName, fileCharPtr);
-    std::string fileCharPtrString(fileCharPtr.dataPtr());
-    std::istringstream infs(fileCharPtrString, std::istringstream::in);
-
-    infs >> m_hdr;
+    ParseHeader(fileCharPtr.dataPtr(), m_hdr);
 
     m_pa.resize(m_hdr.m_ncomp);
 
@@ -1352,6 +2125,7 @@ VisMF::VisMF (const std::string &fafab_name)
 
 VisMF::~VisMF ()
 {
+    clear();    // ---- before the mappings the FABs may alias go away
 }
 
 
@@ -1375,7 +2149,9 @@ VisMF::readFAB (int                  idx,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(hdr.m_vers == Header::Version_v1) {
+    if(Compressed(hdr)) {
+      DecodeFab(*infs, hdr.m_ncomp, whichComp, *fab);
+    } else if(hdr.m_vers == Header::Version_v1) {
       if(whichComp == -1) {    // ---- read all components
         fab->readFrom(*infs);
       } else {
@@ -1425,7 +2201,9 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
     std::ifstream *infs = VisMF::OpenStream(FullName);
     infs->seekg(hdr.m_fod[idx].m_head, std::ios::beg);
 
-    if(NoFabHeader(hdr)) {
+    if(Compressed(hdr)) {
+      DecodeFab(*infs, hdr.m_ncomp, -1, fab);
+    } else if(NoFabHeader(hdr)) {
       if(hdr.m_writtenRD == FPC::NativeRealDescriptor()) {
         infs->read((char *) fab.dataPtr(), fab.nBytes());
       } else {
@@ -1465,17 +2243,13 @@ VisMF::Read (FabArray<FArrayBox> &mf,
 
     {
         hStartTime = amrex::second();
-        std::string fileCharPtrString;
 	if(faHeader == nullptr) {
           Vector<char> fileCharPtr;
           ParallelDescriptor::ReadAndBcastFile(FullHdrFileName, fileCharPtr);
-          fileCharPtrString = fileCharPtr.dataPtr();
+          ParseHeader(fileCharPtr.dataPtr(), hdr);
 	} else {
-          fileCharPtrString = faHeader;
+          ParseHeader(faHeader, hdr);
 	}
-        std::istringstream infs(fileCharPtrString, std::istringstream::in);
-
-        infs >> hdr;
 
         hEndTime = amrex::second();
     }
@@ -1496,6 +2270,22 @@ VisMF::Read (FabArray<FArrayBox> &mf,
     if (mf.empty()) {
 	DistributionMapping dm(hdr.m_ba);
 	mf.define(hdr.m_ba, dm, hdr.m_ncomp, hdr.m_ngrow, MFInfo(), FArrayBoxFactory());
+    } else if (useDirectReads && ! amrex::match(hdr.m_ba,mf.boxArray())) {
+        // ---- Read the FABs on disk on the processes owning most of their
+        // ---- cells, then move only the pieces owned by other processes.
+        BL_ASSERT(mf.nComp() == hdr.m_ncomp);
+        AMREX_ALWAYS_ASSERT(hdr.m_ba.contains(mf.boxArray()));
+        FabArray<FArrayBox> fafabDisk(hdr.m_ba, OwnerDistributionMap(hdr.m_ba, mf),
+                                      hdr.m_ncomp, hdr.m_ngrow, MFInfo(), FArrayBoxFactory());
+        VisMF::Read(fafabDisk, mf_name, faHeader, coordinatorProc, allow_empty_mf);
+        faCopyTime = amrex::second();
+        mf.ParallelCopy(fafabDisk, 0, 0, hdr.m_ncomp);
+        faCopyTime = amrex::second() - faCopyTime;
+        if(myProc == coordinatorProc && verbose) {
+          amrex::AllPrint() << "FARead ::  redistributed " << hdr.m_ba.size() << " boxes onto "
+                            << mf.boxArray().size() << "  faCopyTime = " << faCopyTime << std::endl;
+        }
+        return;
     } else {
 	BL_ASSERT(amrex::match(hdr.m_ba,mf.boxArray()));
     }
@@ -1507,7 +2297,15 @@ VisMF::Read (FabArray<FArrayBox> &mf,
   int nProcs(ParallelDescriptor::NProcs());
   bool noFabHeader(NoFabHeader(hdr));
 
-  if(noFabHeader && useSynchronousReads) {
+  if(useDirectReads) {
+
+    // ---- Every process reads the FABs it owns, seeking by their offsets
+    // ---- in the header, without a coordinator.
+    for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+      VisMF::readFAB(mf, mfi.index(), mf_name, hdr);
+    }
+
+  } else if(noFabHeader && useSynchronousReads) {
 
     // ---- This code is only for reading in file order
     bool doConvert(hdr.m_writtenRD != FPC::NativeRealDescriptor());
@@ -1900,6 +2698,98 @@ VisMF::Read (FabArray<FArrayBox> &mf,
 }
 
 
+void
+VisMF::Read (FabArray<BaseFab<float> > &mf,
+             const std::string &mf_name)
+{
+    BL_PROFILE("VisMF::Read(FabArray<float>)");
+
+    VisMF::Header hdr;
+    {
+        std::string FullHdrFileName(mf_name + TheMultiFabHdrFileSuffix);
+        Vector<char> fileCharPtr;
+        ParallelDescriptor::ReadAndBcastFile(FullHdrFileName, fileCharPtr);
+        ParseHeader(fileCharPtr.dataPtr(), hdr);
+    }
+
+    if (mf.empty()) {
+        DistributionMapping dm(hdr.m_ba);
+        mf.define(hdr.m_ba, dm, hdr.m_ncomp, hdr.m_ngrow);
+    } else if (! amrex::match(hdr.m_ba,mf.boxArray()) || mf.nGrowVect() != hdr.m_ngrow) {
+        // ---- As in the Real Read, read the FABs as they are on disk, on the
+        // ---- processes owning most of their cells, and copy the valid cells.
+        AMREX_ALWAYS_ASSERT(mf.nComp() == hdr.m_ncomp);
+        AMREX_ALWAYS_ASSERT(hdr.m_ba.contains(mf.boxArray()));
+        FabArray<BaseFab<float> > fafabDisk(hdr.m_ba, OwnerDistributionMap(hdr.m_ba, mf),
+                                            hdr.m_ncomp, hdr.m_ngrow);
+        VisMF::Read(fafabDisk, mf_name);
+        mf.ParallelCopy(fafabDisk, 0, 0, hdr.m_ncomp);
+        return;
+    } else {
+        AMREX_ALWAYS_ASSERT(mf.nComp() == hdr.m_ncomp);
+    }
+
+    const bool noFabHeader(NoFabHeader(hdr));
+    const bool isFloat(noFabHeader && hdr.m_writtenRD == FPC::Native32RealDescriptor());
+    const int myProc(ParallelDescriptor::MyProc());
+
+    // ---- [filename, ranks] and [filename, local fab indices]
+    std::map<std::string, std::set<int> > readFileRanks;
+    std::map<std::string, Vector<int> > readFileFabs;
+    const DistributionMapping &dm = mf.DistributionMap();
+    for(int i(0); i < hdr.m_ba.size(); ++i) {
+      readFileRanks[hdr.m_fod[i].m_name].insert(dm[i]);
+      if(dm[i] == myProc) {
+        readFileFabs[hdr.m_fod[i].m_name].push_back(i);
+      }
+    }
+
+    // ---- As in the Real Read, at most nMFFileInStreams ranks read a file
+    // ---- at a time.  Every rank goes through the files in the same order.
+    for(auto &rfr : readFileRanks) {
+      const std::string &fileName = rfr.first;
+      const Vector<int> allRanks(rfr.second.begin(), rfr.second.end());
+      const int nStreams(std::min<int>(allRanks.size(), nMFFileInStreams));
+      Vector<int> nRanksPerStream(nStreams);
+      amrex::NItemsPerBin(allRanks.size(), nRanksPerStream);
+
+      int firstRank(0);
+      for(int iSet(0); iSet < nStreams; ++iSet) {
+        Vector<int> readRanks(allRanks.begin() + firstRank,
+                              allRanks.begin() + firstRank + nRanksPerStream[iSet]);
+        firstRank += nRanksPerStream[iSet];
+        if(std::find(readRanks.begin(), readRanks.end(), myProc) == readRanks.end()) {
+          continue;
+        }
+
+        std::string fullFileName(VisMF::DirName(mf_name) + fileName);
+        for(NFilesIter nfi(fullFileName, readRanks); nfi.ReadyToRead(); ++nfi) {
+          for(int idx : readFileFabs[fileName]) {
+            BaseFab<float> &fab = mf[idx];
+            if(isFloat) {
+              nfi.Stream().seekg(hdr.m_fod[idx].m_head, std::ios::beg);
+              nfi.Stream().read((char *) fab.dataPtr(), fab.nBytes());
+              if( ! nfi.Stream().good()) {
+                amrex::Error("VisMF::Read:  problem reading " + fullFileName);
+              }
+            } else {
+              // ---- any other format is converted to Real first
+              std::unique_ptr<FArrayBox> rfab(VisMF::readFAB(idx, mf_name, hdr));
+              AMREX_ALWAYS_ASSERT(rfab->box() == fab.box() && rfab->nComp() == fab.nComp());
+              const long n(fab.box().numPts() * fab.nComp());
+              const Real *src = rfab->dataPtr();
+              float *dst = fab.dataPtr();
+              for(long i(0); i < n; ++i) {
+                dst[i] = static_cast<float>(src[i]);
+              }
+            }
+          }
+        }
+      }
+    }
+}
+
+
 bool
 VisMF::Exist (const std::string& mf_name)
 {
@@ -1914,6 +2804,30 @@ VisMF::Exist (const std::string& mf_name)
     return exist;
 }
 
+void
+VisMF::ConvertHeader (const std::string &mf_name, bool binary)
+{
+    if(ParallelDescriptor::IOProcessor()) {
+        std::string FullHdrFileName(mf_name + TheMultiFabHdrFileSuffix);
+        std::ifstream ifs(FullHdrFileName.c_str(), std::ios::in | std::ios::binary);
+        if( ! ifs.good()) {
+            amrex::FileOpenFailed(FullHdrFileName);
+        }
+        std::string fileChars((std::istreambuf_iterator<char>(ifs)),
+                              std::istreambuf_iterator<char>());
+        ifs.close();
+
+        VisMF::Header hdr;
+        ParseHeader(fileChars.c_str(), hdr);
+
+        const bool saveBinaryHeader(binaryHeader);
+        binaryHeader = binary;
+        WriteHeaderDoit(mf_name, hdr);
+        binaryHeader = saveBinaryHeader;
+    }
+    ParallelDescriptor::Barrier();
+}
+
 void
 VisMF::ReadFAHeader (const std::string &fafabName,
 	             Vector<char> &faHeader)
@@ -1945,9 +2859,11 @@ VisMF::Check (const std::string& mf_name)
     FullHdrFileName += TheMultiFabHdrFileSuffix;
 
     {
-        std::ifstream ifs(FullHdrFileName.c_str());
-        ifs >> hdr;
+        std::ifstream ifs(FullHdrFileName.c_str(), std::ios::in | std::ios::binary);
+        std::string fileChars((std::istreambuf_iterator<char>(ifs)),
+                              std::istreambuf_iterator<char>());
         ifs.close();
+        ParseHeader(fileChars.c_str(), hdr);
     }
 
     if (verbose) {
@@ -2034,7 +2950,7 @@ void
 VisMF::clear (int fabIndex)
 {
     for(int ncomp(0), N(m_pa.size()); ncomp < N; ++ncomp) {
-        clear(ncomp, fabIndex);
+        clear(fabIndex, ncomp);
     }
 }
 
@@ -2043,7 +2959,7 @@ VisMF::clear ()
 {
     for(int ncomp(0), N(m_pa.size()); ncomp < N; ++ncomp) {
         for(int fabIndex(0), M(m_pa[ncomp].size()); fabIndex < M; ++fabIndex) {
-            clear(ncomp, fabIndex);
+            clear(fabIndex, ncomp);
         }
     }
 }
@@ -2060,6 +2976,11 @@ bool VisMF::NoFabHeader(const VisMF::Header &hdr) {
 }
 
 
+bool VisMF::Compressed(const VisMF::Header &hdr) {
+  return hdr.m_vers == VisMF::Header::Compressed_v1;
+}
+
+
 VisMF::PersistentIFStream::PersistentIFStream()
     :
     pstr(0),
@@ -2161,7 +3082,9 @@ VisMF::WriteAsync (const FabArray<FArrayBox>& mf, const std::string& mf_name)
     }();
     bool doConvert = whichRD != FPC::NativeRealDescriptor();
 
-    VisMF::Header hdr(mf, VisMF::NFiles, VisMF::Header::Version_v1, true);
+    const bool compressed(currentVersion == VisMF::Header::Compressed_v1);
+    VisMF::Header hdr(mf, VisMF::NFiles,
+                      compressed ? VisMF::Header::Compressed_v1 : VisMF::Header::Version_v1, true);
 
     const int nspots = (nprocs + (nfiles-1)) / nfiles;   // max spots per file
     const int nfull = nfiles + nprocs - nspots*nfiles;  // the first nfull files are full
@@ -2205,6 +3128,7 @@ VisMF::WriteAsync (const FabArray<FArrayBox>& mf, const std::string& mf_name)
     int64_t total_bytes = 0;
     auto pld = (char*)(&(localdata[1]));
     const FABio& fio = FArrayBox::getFABio();
+    Vector<char> compressedData;
     for (MFIter mfi(mf); mfi.isValid(); ++mfi)
     {
         std::memcpy(pld, &total_bytes, sizeof(int64_t));
@@ -2212,10 +3136,20 @@ VisMF::WriteAsync (const FabArray<FArrayBox>& mf, const std::string& mf_name)
 
         const FArrayBox& fab = mf[mfi];
 
-        std::stringstream hss;
-        fio.write_header(hss, fab, ncomp);
-        total_bytes += static_cast<std::streamoff>(hss.tellp());
-        total_bytes += fab.size() * whichRD.numBytes();
+        if (compressed) {
+#ifdef AMREX_USE_GPU
+            FArrayBox hfab(fab.box(), ncomp, The_Pinned_Arena());
+            Gpu::dtoh_memcpy(hfab.dataPtr(), fab.dataPtr(), fab.nBytes());
+            total_bytes += EncodeFab(hfab, compressedData);
+#else
+            total_bytes += EncodeFab(fab, compressedData);
+#endif
+        } else {
+            std::stringstream hss;
+            fio.write_header(hss, fab, ncomp);
+            total_bytes += static_cast<std::streamoff>(hss.tellp());
+            total_bytes += fab.size() * whichRD.numBytes();
+        }
 
         // compute min and max
         const Box& bx = mfi.validbox();
@@ -2297,7 +3231,10 @@ VisMF::WriteAsync (const FabArray<FArrayBox>& mf, const std::string& mf_name)
                                               DataDeleter(The_Pinned_Arena()));
     char* p = alldata.get();
     void* ptmp;
-    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    if (compressed && total_bytes > 0) {
+        std::memcpy(p, compressedData.dataPtr(), total_bytes);
+    }
+    for (MFIter mfi(mf); mfi.isValid() && !compressed; ++mfi)
     {
         const FArrayBox& fab = mf[mfi];
         std::stringstream hss;
@@ -2435,15 +3372,20 @@ VisMF::WriteAsync (const FabArray<FArrayBox>& mf, const std::string& mf_name)
 
         Real t1 = amrex::second();
 
+        // A failure is reported in the status, and the next process still
+        // gets its turn.
+        bool ok = true;
         if (total_bytes > 0) {
             std::string file_name = amrex::Concatenate(mf_name + FabFileSuffix, ifile, 5);
             std::ofstream ofs;
             ofs.open(file_name.c_str(), (ispot == 0)
                      ? (std::ios::binary | std::ios::trunc)
                      : (std::ios::binary | std::ios::app));
-            if (!ofs.good()) amrex::FileOpenFailed(file_name);
-            ofs.write(d.get(), total_bytes);
-            ofs.close();
+            if (ofs.good()) {
+                ofs.write(d.get(), total_bytes);
+                ofs.close();
+            }
+            ok = ofs.good();
         }
 
         Real t2 = amrex::second();
@@ -2464,6 +3406,7 @@ VisMF::WriteAsync (const FabArray<FArrayBox>& mf, const std::string& mf_name)
         status.t_spin = t1-t0;
         status.t_write = t2-t1;
         status.t_send = tend-t2;
+        status.ok = ok;
         return status;
     },
     std::move(alldata), std::move(hdr), std::move(globaldata));
@@ -2477,7 +3420,7 @@ operator<< (std::ostream& os, const WriteAsyncStatus& status)
     os << "total bytes: " << status.nbytes << ", nspins: " << status.nspins
        << ", t_total: " << status.t_total << ", t_header: " << status.t_header
        << ", t_spin: " << status.t_spin << ", t_write: " << status.t_write
-       << ", t_send: " << status.t_send;
+       << ", t_send: " << status.t_send << (status.ok ? "" : ", FAILED");
     return os;
 }
 
@@ -326,7 +326,11 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
     const Real alpha = m_a_scalar;
 
     MFItInfo mfi_info;
-    if (Gpu::notInLaunchRegion()) mfi_info.EnableTiling().SetDynamic(true);
+    if (Gpu::notInLaunchRegion()) {
+        // The fused passes sweep whole boxes; see MLCellLinOp::smooth.
+        if (redblack < gsrb_fused_interior) mfi_info.EnableTiling();
+        mfi_info.SetDynamic(true);
+    }
 
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
@@ -344,7 +348,6 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
 #endif
 #endif
 
-	const Box& tbx = mfi.tilebox();
         const Box& vbx = mfi.validbox();
         const auto& solnfab = sol.array(mfi);
         const auto& rhsfab  = rhs.array(mfi);
@@ -365,17 +368,23 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
 #endif
 #endif
 
-        AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
+        for (const auto& sweep : gsrbBoxes(mfi, redblack))
         {
-            abec_gsrb(thread_box, solnfab, rhsfab, alpha, afab,
-                      AMREX_D_DECL(dhx, dhy, dhz),
-                      AMREX_D_DECL(bxfab, byfab, bzfab),
-                      AMREX_D_DECL(m0,m2,m4),
-                      AMREX_D_DECL(m1,m3,m5),
-                      AMREX_D_DECL(f0fab,f2fab,f4fab),
-                      AMREX_D_DECL(f1fab,f3fab,f5fab),
-                      vbx, redblack, nc);
-        });
+            const Box& tbx = sweep.first;
+            const int rb = sweep.second;
+
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
+            {
+                abec_gsrb(thread_box, solnfab, rhsfab, alpha, afab,
+                          AMREX_D_DECL(dhx, dhy, dhz),
+                          AMREX_D_DECL(bxfab, byfab, bzfab),
+                          AMREX_D_DECL(m0,m2,m4),
+                          AMREX_D_DECL(m1,m3,m5),
+                          AMREX_D_DECL(f0fab,f2fab,f4fab),
+                          AMREX_D_DECL(f1fab,f3fab,f5fab),
+                          vbx, rb, nc);
+            });
+        }
     }
 }
 
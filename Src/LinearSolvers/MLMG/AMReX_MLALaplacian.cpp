@@ -277,7 +277,11 @@ MLALaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs
     const Real alpha = m_a_scalar;
 
     MFItInfo mfi_info;
-    if (Gpu::notInLaunchRegion()) mfi_info.EnableTiling().SetDynamic(true);
+    if (Gpu::notInLaunchRegion()) {
+        // The fused passes sweep whole boxes; see MLCellLinOp::smooth.
+        if (redblack < gsrb_fused_interior) mfi_info.EnableTiling();
+        mfi_info.SetDynamic(true);
+    }
 
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
@@ -295,7 +299,6 @@ MLALaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs
 #endif
 #endif
 
-	const Box& tbx = mfi.tilebox();
         const Box& vbx = mfi.validbox();
         const auto& solnfab = sol.array(mfi);
         const auto& rhsfab  = rhs.array(mfi);
@@ -312,71 +315,77 @@ MLALaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs
 #endif
 #endif
 
+        for (const auto& sweep : gsrbBoxes(mfi, redblack))
+        {
+            const Box& tbx = sweep.first;
+            const int rb = sweep.second;
+
 #if (AMREX_SPACEDIM == 1)
-        if (m_has_metric_term) {
-            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
-            {
-                mlalap_gsrb_m(thread_box, solnfab, rhsfab, alpha, dhx,
-                              afab,
-                              f0fab, m0,
-                              f1fab, m1,
-                              vbx, redblack,
-                              dx, probxlo);
-            });
-        } else {
-            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
-            {
-                mlalap_gsrb(thread_box, solnfab, rhsfab, alpha, dhx,
-                            afab,
-                            f0fab, m0,
-                            f1fab, m1,
-                            vbx, redblack);
-            });
-        }
+            if (m_has_metric_term) {
+                AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
+                {
+                    mlalap_gsrb_m(thread_box, solnfab, rhsfab, alpha, dhx,
+                                  afab,
+                                  f0fab, m0,
+                                  f1fab, m1,
+                                  vbx, rb,
+                                  dx, probxlo);
+                });
+            } else {
+                AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
+                {
+                    mlalap_gsrb(thread_box, solnfab, rhsfab, alpha, dhx,
+                                afab,
+                                f0fab, m0,
+                                f1fab, m1,
+                                vbx, rb);
+                });
+            }
 
 #endif
 
 #if (AMREX_SPACEDIM == 2)
-        if (m_has_metric_term) {
-            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
-            {
-                mlalap_gsrb_m(thread_box, solnfab, rhsfab, alpha, dhx, dhy,
-                              afab,
-                              f0fab, m0,
-                              f1fab, m1,
-                              f2fab, m2,
-                              f3fab, m3,
-                              vbx, redblack,
-                              dx, probxlo);
-            });
-        } else {
+            if (m_has_metric_term) {
+                AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
+                {
+                    mlalap_gsrb_m(thread_box, solnfab, rhsfab, alpha, dhx, dhy,
+                                  afab,
+                                  f0fab, m0,
+                                  f1fab, m1,
+                                  f2fab, m2,
+                                  f3fab, m3,
+                                  vbx, rb,
+                                  dx, probxlo);
+                });
+            } else {
+                AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
+                {
+                    mlalap_gsrb(thread_box, solnfab, rhsfab, alpha, dhx, dhy,
+                                afab,
+                                f0fab, m0,
+                                f1fab, m1,
+                                f2fab, m2,
+                                f3fab, m3,
+                                vbx, rb);
+                });
+            }
+#endif
+
+#if (AMREX_SPACEDIM == 3)
             AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
             {
-                mlalap_gsrb(thread_box, solnfab, rhsfab, alpha, dhx, dhy,
+                mlalap_gsrb(thread_box, solnfab, rhsfab, alpha, dhx, dhy, dhz,
                             afab,
                             f0fab, m0,
                             f1fab, m1,
                             f2fab, m2,
                             f3fab, m3,
-                            vbx, redblack);
+                            f4fab, m4,
+                            f5fab, m5,
+                            vbx, rb);
             });
-        }
-#endif
-
-#if (AMREX_SPACEDIM == 3)
-        AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( tbx, thread_box,
-        {
-            mlalap_gsrb(thread_box, solnfab, rhsfab, alpha, dhx, dhy, dhz,
-                        afab,
-                        f0fab, m0,
-                        f1fab, m1,
-                        f2fab, m2,
-                        f3fab, m3,
-                        f4fab, m4,
-                        f5fab, m5,
-                        vbx, redblack);
-        });
 #endif
+        }
     }
 }
 
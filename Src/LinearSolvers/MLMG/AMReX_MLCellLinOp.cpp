@@ -341,6 +341,29 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
                      bool skip_fillboundary) const
 {
     BL_PROFILE("MLCellLinOp::smooth()");
+    if (m_fused_smooth && supportsFusedSmooth() && isCrossStencil() && Gpu::notInLaunchRegion())
+    {
+        //
+        // The black cells that neither applyBC nor the ghost cells of other
+        // boxes read can be updated as soon as their red neighbors are.  So
+        // the first pass sweeps each box once, red on a plane and black on
+        // the interior of the plane behind it.  The second pass does black
+        // on the rest after applyBC.  The result is that of the loop below.
+        //
+        applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution,
+                nullptr, skip_fillboundary);
+#ifdef AMREX_SOFT_PERF_COUNTERS
+        perf_counters.smooth(sol);
+#endif
+        Fsmooth(amrlev, mglev, sol, rhs, gsrb_fused_interior);
+        applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution);
+#ifdef AMREX_SOFT_PERF_COUNTERS
+        perf_counters.smooth(sol);
+#endif
+        Fsmooth(amrlev, mglev, sol, rhs, gsrb_fused_shell);
+        return;
+    }
+
     for (int redblack = 0; redblack < 2; ++redblack)
     {
         applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution,
@@ -353,6 +376,56 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
     }
 }
 
+Vector<std::pair<Box,int> >
+MLCellLinOp::gsrbBoxes (const MFIter& mfi, int redblack) const
+{
+    Vector<std::pair<Box,int> > r;
+
+    if (redblack < gsrb_fused_interior) {
+        r.emplace_back(mfi.tilebox(), redblack);
+        return r;
+    }
+
+    //
+    // applyBC extrapolates from up to maxorder-1 cells next to a boundary,
+    // and other boxes take their ghost cells from the first one.
+    //
+    const Box& vbx = mfi.validbox();
+    const Box interior = amrex::grow(vbx, -std::max(1,maxorder-1));
+
+    if (redblack == gsrb_fused_interior)
+    {
+        constexpr int idim = AMREX_SPACEDIM-1;
+        const int lo = vbx.smallEnd(idim);
+        const int hi = vbx.bigEnd(idim);
+        for (int p = lo; p <= hi+1; ++p)
+        {
+            if (p <= hi) {
+                Box b = vbx;
+                b.setRange(idim, p);
+                r.emplace_back(b, 0);
+            }
+            if (interior.ok() && p-1 >= interior.smallEnd(idim) && p-1 <= interior.bigEnd(idim)) {
+                Box b = interior;
+                b.setRange(idim, p-1);
+                r.emplace_back(b, 1);
+            }
+        }
+    }
+    else if (interior.ok())
+    {
+        for (const Box& b : amrex::boxDiff(vbx, interior)) {
+            r.emplace_back(b, 1);
+        }
+    }
+    else
+    {
+        r.emplace_back(vbx, 1);
+    }
+
+    return r;
+}
+
 void
 MLCellLinOp::updateSolBC (int amrlev, const MultiFab& crse_bcdata) const
 {
@@ -36,6 +36,7 @@ namespace {
     int flag_comm_cache = 0;
     int flag_use_mota = 0;
     int remap_nbh_lb = 1;
+    int flag_fused_smooth = 0;
 
 #ifdef BL_USE_MPI
     class CommCache
@@ -98,6 +99,7 @@ void MLLinOp::Initialize ()
     pp.query("comm_cache", flag_comm_cache);
     pp.query("mota", flag_use_mota);
     pp.query("remap_nbh_lb", remap_nbh_lb);
+    pp.query("fused_smooth", flag_fused_smooth);
 
 #ifdef BL_USE_MPI
     comm_cache.reset(new CommCache());
@@ -136,6 +138,7 @@ MLLinOp::define (const Vector<Geometry>& a_geom,
     }
 
     info = a_info;
+    m_fused_smooth = flag_fused_smooth;
 #ifdef AMREX_USE_EB
     if (!a_factory.empty()){
         auto f = dynamic_cast<EBFArrayBoxFactory const*>(a_factory[0]);
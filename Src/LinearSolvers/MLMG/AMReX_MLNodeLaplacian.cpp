@@ -1346,8 +1346,8 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                 }
 #endif
 
-                for (int ns = 0; ns < nsweeps; ++ns) {
-                    AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+                for (const Box& sbx : gaussSeidelBoxes(bx, nsweeps)) {
+                    AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( sbx, tbx,
                     {
                         mlndlap_gauss_seidel_sten(tbx,solarr,rhsarr,starr,dmskarr);
                     });
@@ -1369,8 +1369,8 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                 Array4<Real const> const& rhsarr = rhs.const_array(mfi);
                 Array4<int const> const& dmskarr = dmsk.const_array(mfi);
 
-                for (int ns = 0; ns < nsweeps; ++ns) {
-                    AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+                for (const Box& sbx : gaussSeidelBoxes(bx, nsweeps)) {
+                    AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( sbx, tbx,
                     {
                         mlndlap_gauss_seidel_ha(tbx, solarr, rhsarr,
                                                 AMREX_D_DECL(sxarr,syarr,szarr),
@@ -1396,8 +1396,8 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                 Array4<Real const> const& rhsarr = rhs.const_array(mfi);
                 Array4<int const> const& dmskarr = dmsk.const_array(mfi);
 
-                for (int ns = 0; ns < nsweeps; ++ns) {
-                    AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+                for (const Box& sbx : gaussSeidelBoxes(bx, nsweeps)) {
+                    AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( sbx, tbx,
                     {
                         mlndlap_gauss_seidel_aa(tbx, solarr, rhsarr,
                                                 sarr, dmskarr, dxinvarr
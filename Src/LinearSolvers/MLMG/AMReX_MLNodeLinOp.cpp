@@ -131,6 +131,35 @@ MLNodeLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
     Fsmooth(amrlev, mglev, sol, rhs);
 }
 
+Vector<Box>
+MLNodeLinOp::gaussSeidelBoxes (const Box& bx, int nsweeps) const
+{
+    if (!m_fused_smooth || Gpu::inLaunchRegion()) {
+        return Vector<Box>(nsweeps, bx);
+    }
+
+    //
+    // A sweep on a plane needs the previous sweep on the plane after it
+    // and its own sweep on the plane before it.  So all sweeps are done on
+    // a few planes at a time, with sweep ns on plane p-ns.
+    //
+    constexpr int idim = AMREX_SPACEDIM-1;
+    const int lo = bx.smallEnd(idim);
+    const int hi = bx.bigEnd(idim);
+    Vector<Box> r;
+    r.reserve(nsweeps*(hi-lo+1));
+    for (int p = lo; p <= hi+nsweeps-1; ++p) {
+        for (int ns = 0; ns < nsweeps; ++ns) {
+            if (p-ns >= lo && p-ns <= hi) {
+                Box b = bx;
+                b.setRange(idim, p-ns);
+                r.push_back(b);
+            }
+        }
+    }
+    return r;
+}
+
 Real
 MLNodeLinOp::xdoty (int amrlev, int mglev, const MultiFab& x, const MultiFab& y, bool local) const
 {
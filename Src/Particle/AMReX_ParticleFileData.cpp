@@ -0,0 +1,281 @@
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include <AMReX_ParticleFileData.H>
+#include <AMReX_NFiles.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VectorIO.H>
+
+namespace amrex {
+
+ParticleFileData::ParticleFileData (const std::string& dir, const std::string& name)
+{
+    m_dir = dir;
+    if (!m_dir.empty() && m_dir[m_dir.size()-1] != '/') m_dir += '/';
+    m_dir += name;
+
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(m_dir + "/Header", fileCharPtr);
+    std::istringstream is(std::string(fileCharPtr.dataPtr()), std::istringstream::in);
+
+    std::string version;
+    is >> version;
+    m_columnar = (version.find("Columnar_One_Dot_Zero") != std::string::npos);
+    if (version.find("Version_One_Dot_Zero") != std::string::npos) {
+        m_single = false;
+    } else if (version.find("_single") != std::string::npos) {
+        m_single = true;
+    } else if (version.find("_double") != std::string::npos) {
+        m_single = false;
+    } else {
+        amrex::Abort("ParticleFileData: unknown version string: " + version);
+    }
+
+    is >> m_spacedim;
+
+    const char* pos_names[] = {"x", "y", "z"};
+    for (int i = 0; i < m_spacedim; ++i) {
+        m_real_names.push_back(pos_names[i]);
+    }
+    int nr;
+    is >> nr;
+    for (int i = 0; i < nr; ++i) {
+        std::string comp;
+        is >> comp;
+        m_real_names.push_back(comp);
+    }
+
+    m_int_names.push_back("id");
+    m_int_names.push_back("cpu");
+    int ni;
+    is >> ni;
+    for (int i = 0; i < ni; ++i) {
+        std::string comp;
+        is >> comp;
+        m_int_names.push_back(comp);
+    }
+
+    bool is_checkpoint;
+    int maxnextid;
+    is >> is_checkpoint >> m_nparticles >> maxnextid >> m_finest_level;
+
+    const int nlevels = m_finest_level + 1;
+    m_which.resize(nlevels);
+    m_count.resize(nlevels);
+    m_where.resize(nlevels);
+    for (int lev = 0; lev < nlevels; ++lev) {
+        int ngrids;
+        is >> ngrids;
+        m_which[lev].resize(ngrids);
+        m_count[lev].resize(ngrids);
+        m_where[lev].resize(ngrids);
+    }
+    for (int lev = 0; lev < nlevels; ++lev) {
+        for (int i = 0, N = m_count[lev].size(); i < N; ++i) {
+            is >> m_which[lev][i] >> m_count[lev][i] >> m_where[lev][i];
+        }
+    }
+
+    if (is.fail()) {
+        amrex::Abort("ParticleFileData: problem reading " + m_dir + "/Header");
+    }
+}
+
+long
+ParticleFileData::numParticles (int level) const noexcept
+{
+    long n = 0;
+    for (int cnt : m_count[level]) {
+        n += cnt;
+    }
+    return n;
+}
+
+int
+ParticleFileData::compIndex (const Vector<std::string>& names, const std::string& comp) const
+{
+    for (int i = 0, N = names.size(); i < N; ++i) {
+        if (names[i] == comp) return i;
+    }
+    amrex::Abort("ParticleFileData: no component " + comp + " in " + m_dir);
+    return -1;
+}
+
+std::string
+ParticleFileData::dataFileName (int level, int grid) const
+{
+    std::string prefix = amrex::Concatenate(m_dir + "/Level_", level, 1);
+    prefix += "/DATA_";
+    return NFilesIter::FileName(m_which[level][grid], prefix);
+}
+
+Vector<int>
+ParticleFileData::fileOrder (int level, const Vector<int>& grids) const
+{
+    Vector<int> order(grids.size());
+    for (int i = 0, N = order.size(); i < N; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&] (int a, int b) {
+        const int ga = grids[a], gb = grids[b];
+        return std::make_pair(m_which[level][ga], m_where[level][ga])
+            <  std::make_pair(m_which[level][gb], m_where[level][gb]);
+    });
+    return order;
+}
+
+void
+ParticleFileData::openDataFile (std::ifstream& ifs, int level, int grid,
+                                int& which, std::string& file) const
+{
+    if (m_which[level][grid] == which) return;
+    which = m_which[level][grid];
+    file  = dataFileName(level, grid);
+    ifs.close();
+    ifs.clear();
+    ifs.open(file, std::ios::in | std::ios::binary);
+    if (!ifs.good()) amrex::FileOpenFailed(file);
+}
+
+void
+ParticleFileData::readReal (int icomp, int level, int grid, std::ifstream& ifs,
+                            const std::string& file, ParticleReal* out) const
+{
+    const long n = m_count[level][grid];
+
+    const int  nint  = m_int_names.size();
+    const int  nreal = m_real_names.size();
+    const long isize = FPC::NativeIntDescriptor().numBytes();
+    const long rsize = m_single ? sizeof(float) : sizeof(double);
+
+    // The reals follow the integers of the grid.
+    long offset = m_where[level][grid] + nint*n*isize;
+    long nread  = n*nreal;
+    if (m_columnar) {
+        offset += icomp*n*rsize;
+        nread   = n;
+    }
+    ifs.seekg(offset, std::ios::beg);
+
+    const long stride = m_columnar ? 1 : nreal;
+    const long first  = m_columnar ? 0 : icomp;
+    if (m_single) {
+        Vector<float> buf(nread);
+        readFloatData(buf.dataPtr(), nread, ifs, FPC::Native32RealDescriptor());
+        for (long i = 0; i < n; ++i) out[i] = buf[first + i*stride];
+    } else {
+        Vector<double> buf(nread);
+        readDoubleData(buf.dataPtr(), nread, ifs, FPC::Native64RealDescriptor());
+        for (long i = 0; i < n; ++i) out[i] = buf[first + i*stride];
+    }
+
+    if (ifs.fail()) {
+        amrex::Error("ParticleFileData: problem reading " + file);
+    }
+}
+
+void
+ParticleFileData::readInt (int icomp, int level, int grid, std::ifstream& ifs,
+                           const std::string& file, int* out) const
+{
+    const long n = m_count[level][grid];
+
+    const int  nint  = m_int_names.size();
+    const long isize = FPC::NativeIntDescriptor().numBytes();
+
+    long offset = m_where[level][grid];
+    long nread  = n*nint;
+    if (m_columnar) {
+        offset += icomp*n*isize;
+        nread   = n;
+    }
+    ifs.seekg(offset, std::ios::beg);
+
+    const long stride = m_columnar ? 1 : nint;
+    const long first  = m_columnar ? 0 : icomp;
+    Vector<int> buf(nread);
+    readIntData(buf.dataPtr(), nread, ifs, FPC::NativeIntDescriptor());
+    for (long i = 0; i < n; ++i) out[i] = buf[first + i*stride];
+
+    if (ifs.fail()) {
+        amrex::Error("ParticleFileData: problem reading " + file);
+    }
+}
+
+Vector<ParticleReal>
+ParticleFileData::getReal (const std::string& comp, int level, int grid) const
+{
+    return getReal(comp, level, Vector<int>(1, grid));
+}
+
+Vector<ParticleReal>
+ParticleFileData::getReal (const std::string& comp, int level, const Vector<int>& grids) const
+{
+    const int icomp = compIndex(m_real_names, comp);
+    Vector<long> start(grids.size()+1, 0);
+    for (int i = 0, N = grids.size(); i < N; ++i) {
+        start[i+1] = start[i] + m_count[level][grids[i]];
+    }
+    Vector<ParticleReal> r(start.back());
+
+    // Read the grids file by file, in the order they are stored.
+    std::ifstream ifs;
+    std::string file;
+    int which = -1;
+    for (int i : fileOrder(level, grids)) {
+        const int grid = grids[i];
+        if (m_count[level][grid] <= 0) continue;
+        openDataFile(ifs, level, grid, which, file);
+        readReal(icomp, level, grid, ifs, file, r.dataPtr() + start[i]);
+    }
+    return r;
+}
+
+Vector<ParticleReal>
+ParticleFileData::getReal (const std::string& comp, int level) const
+{
+    Vector<int> grids(numGrids(level));
+    for (int i = 0, N = grids.size(); i < N; ++i) grids[i] = i;
+    return getReal(comp, level, grids);
+}
+
+Vector<int>
+ParticleFileData::getInt (const std::string& comp, int level, int grid) const
+{
+    return getInt(comp, level, Vector<int>(1, grid));
+}
+
+Vector<int>
+ParticleFileData::getInt (const std::string& comp, int level, const Vector<int>& grids) const
+{
+    const int icomp = compIndex(m_int_names, comp);
+    Vector<long> start(grids.size()+1, 0);
+    for (int i = 0, N = grids.size(); i < N; ++i) {
+        start[i+1] = start[i] + m_count[level][grids[i]];
+    }
+    Vector<int> r(start.back());
+
+    // Read the grids file by file, in the order they are stored.
+    std::ifstream ifs;
+    std::string file;
+    int which = -1;
+    for (int i : fileOrder(level, grids)) {
+        const int grid = grids[i];
+        if (m_count[level][grid] <= 0) continue;
+        openDataFile(ifs, level, grid, which, file);
+        readInt(icomp, level, grid, ifs, file, r.dataPtr() + start[i]);
+    }
+    return r;
+}
+
+Vector<int>
+ParticleFileData::getInt (const std::string& comp, int level) const
+{
+    Vector<int> grids(numGrids(level));
+    for (int i = 0, N = grids.size(); i < N; ++i) grids[i] = i;
+    return getInt(comp, level, grids);
+}
+
+}
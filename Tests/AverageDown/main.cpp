@@ -0,0 +1,222 @@
+//
+// Checks FabArray::ParallelCopyFromKernel against ParallelCopy from a
+// filled FabArray, and the averaging functions that use it against the
+// same averages written to a temporary coarsened-fine MultiFab followed
+// by ParallelCopy.  The coarse and fine layouts differ, so the data go
+// through the kernel path, locally and, on several processes, through
+// the send buffers.  All results must be bitwise equal.  Aborts on any
+// failure.
+//
+#include <cmath>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_MultiFabUtil_C.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("AverageDown: " + what);
+}
+
+AMREX_FORCE_INLINE
+Real value (int i, int j, int k, int n)
+{
+    return std::sin(0.1*i + 0.2*j + 0.3*k + n);
+}
+
+void fill (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), mf.nComp(), [&] (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = value(i,j,k,n);
+        });
+    }
+}
+
+//! Whether a and b are bitwise equal on valid + nghost cells.
+bool same (const MultiFab& a, const MultiFab& b, int nghost)
+{
+    long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& x = a.const_array(mfi);
+        auto const& y = b.const_array(mfi);
+        amrex::LoopOnCpu(amrex::grow(mfi.validbox(),nghost), a.nComp(), [&] (int i, int j, int k, int n)
+        {
+            if (x(i,j,k,n) != y(i,j,k,n)) ++ndiff;
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff == 0;
+}
+
+/**
+* \brief The reference path: f(bx, crse, fine, fine_index) averages into a
+* temporary on the coarsened fine BoxArray, which is then copied to crse.
+*/
+template <class F>
+void reference (const MultiFab& fine, MultiFab& crse, int scomp, int ncomp,
+                const IntVect& ratio, int nghost, F&& f)
+{
+    MultiFab tmp(amrex::coarsen(fine.boxArray(),ratio), fine.DistributionMap(), ncomp, nghost);
+    for (MFIter mfi(tmp); mfi.isValid(); ++mfi) {
+        f(mfi.growntilebox(nghost), tmp.array(mfi), fine.const_array(mfi), mfi.index());
+    }
+    crse.ParallelCopy(tmp, 0, scomp, ncomp, nghost, nghost);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int fine_max_grid_size = 32;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("fine_max_grid_size", fine_max_grid_size);
+        }
+
+        const IntVect ratio(2);
+        const Box cdomain(IntVect(0), IntVect(n_cell-1));
+        BoxArray cba(cdomain);
+        cba.maxSize(max_grid_size);
+        // The fine level covers the middle half of the domain.
+        BoxArray fba(amrex::refine(amrex::grow(cdomain, -n_cell/4), ratio));
+        fba.maxSize(fine_max_grid_size);
+        DistributionMapping cdm(cba), fdm(fba);
+
+        {
+            // A shifted source layout that overlaps several coarse boxes.
+            BoxArray sba(amrex::shift(cdomain, 0, 3));
+            sba.maxSize(max_grid_size+4);
+            DistributionMapping sdm(sba);
+            const int ncomp = 2, ng = 1;
+            MultiFab src(sba, sdm, ncomp, ng);
+            fill(src);
+            MultiFab a(cba, cdm, ncomp+1, ng), b(cba, cdm, ncomp+1, ng);
+            a.setVal(-1.0);
+            b.setVal(-1.0);
+            a.ParallelCopyFromKernel(sba, sdm, 1, ncomp, IntVect(ng), IntVect(ng),
+            [&] (Box const& bx, Array4<Real> const& d, int)
+            {
+                amrex::LoopOnCpu(bx, ncomp, [&] (int i, int j, int k, int n)
+                {
+                    d(i,j,k,n) = value(i,j,k,n);
+                });
+            });
+            b.ParallelCopy(src, 0, 1, ncomp, ng, ng);
+            check(same(a, b, ng), "ParallelCopyFromKernel equals ParallelCopy");
+        }
+
+        {
+            const int ncomp = 3, scomp = 1, nc = 2;
+            MultiFab fine(fba, fdm, ncomp, 0);
+            fill(fine);
+            MultiFab a(cba, cdm, ncomp, 0), b(cba, cdm, ncomp, 0);
+            a.setVal(-1.0);
+            b.setVal(-1.0);
+            amrex::average_down(fine, a, scomp, nc, ratio);
+            reference(fine, b, scomp, nc, ratio, 0,
+            [&] (Box const& bx, Array4<Real> const& c, Array4<Real const> const& f, int)
+            {
+                amrex_avgdown(bx, c, f, 0, scomp, nc, ratio);
+            });
+            check(same(a, b, 0), "average_down");
+
+#if (AMREX_SPACEDIM < 3)
+            // Volume weighted, on RZ coordinates.
+            const RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+            const Geometry cgeom(cdomain, &rb, 1);
+            const Geometry fgeom(amrex::refine(cdomain,ratio), &rb, 1);
+            a.setVal(-1.0);
+            b.setVal(-1.0);
+            amrex::average_down(fine, a, fgeom, cgeom, scomp, nc, ratio);
+            MultiFab fvolume;
+            fgeom.GetVolume(fvolume, fba, fdm, 0);
+            reference(fine, b, scomp, nc, ratio, 0,
+            [&] (Box const& bx, Array4<Real> const& c, Array4<Real const> const& f, int fi)
+            {
+                amrex_avgdown_with_vol(bx, c, f, fvolume.const_array(fi), 0, scomp, nc, ratio);
+            });
+            check(same(a, b, 0), "average_down with volume weighting");
+#endif
+        }
+
+        {
+            const IntVect nodal(1);
+            const int ncomp = 2;
+            MultiFab fine(amrex::convert(fba,nodal), fdm, ncomp, 0);
+            fill(fine);
+            MultiFab a(amrex::convert(cba,nodal), cdm, ncomp, 0);
+            MultiFab b(amrex::convert(cba,nodal), cdm, ncomp, 0);
+            a.setVal(-1.0);
+            b.setVal(-1.0);
+            amrex::average_down(fine, a, 0, ncomp, ratio);
+            amrex::average_down_nodal(fine, b, ratio);
+            check(same(a, b, 0), "average_down of nodal data equals average_down_nodal");
+            b.setVal(-1.0);
+            reference(fine, b, 0, ncomp, ratio, 0,
+            [&] (Box const& bx, Array4<Real> const& c, Array4<Real const> const& f, int)
+            {
+                amrex_avgdown_nodes(bx, c, f, 0, 0, ncomp, ratio);
+            });
+            check(same(a, b, 0), "average_down_nodal");
+        }
+
+        const int ngcrse = 1;
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+        {
+            const std::string d = " in direction " + std::to_string(dir);
+            const int ncomp = 2;
+            {
+                const IntVect face = IntVect::TheDimensionVector(dir);
+                MultiFab fine(amrex::convert(fba,face), fdm, ncomp, ngcrse*ratio[0]);
+                fill(fine);
+                MultiFab a(amrex::convert(cba,face), cdm, ncomp, ngcrse);
+                MultiFab b(amrex::convert(cba,face), cdm, ncomp, ngcrse);
+                a.setVal(-1.0);
+                b.setVal(-1.0);
+                amrex::average_down_faces(fine, a, ratio, ngcrse);
+                reference(fine, b, 0, ncomp, ratio, ngcrse,
+                [&] (Box const& bx, Array4<Real> const& c, Array4<Real const> const& f, int)
+                {
+                    amrex_avgdown_faces(bx, c, f, 0, 0, ncomp, ratio, dir);
+                });
+                check(same(a, b, ngcrse), "average_down_faces" + d);
+            }
+            {
+                const IntVect edge = IntVect(1) - IntVect::TheDimensionVector(dir);
+                MultiFab fine(amrex::convert(fba,edge), fdm, ncomp, ngcrse*ratio[0]);
+                fill(fine);
+                MultiFab a(amrex::convert(cba,edge), cdm, ncomp, ngcrse);
+                MultiFab b(amrex::convert(cba,edge), cdm, ncomp, ngcrse);
+                a.setVal(-1.0);
+                b.setVal(-1.0);
+                amrex::average_down_edges(fine, a, ratio, ngcrse);
+                reference(fine, b, 0, ncomp, ratio, ngcrse,
+                [&] (Box const& bx, Array4<Real> const& c, Array4<Real const> const& f, int)
+                {
+                    amrex_avgdown_edges(bx, c, f, 0, 0, ncomp, ratio, dir);
+                });
+                check(same(a, b, ngcrse), "average_down_edges" + d);
+            }
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,200 @@
+//
+// Compares component-major (FArrayBox) and component-interleaved
+// (BlockedFab) storage on a kernel that uses every component of a cell:
+// a mixture equation of state computing pressure and sound speed from
+// density, momentum, energy and nspec mass fractions.  With the default
+// 14 components BlockedFab is slower than FArrayBox on one core; it wins
+// with many more components (e.g., nspec = 60).
+//
+// It also checks that FillBoundary and ParallelCopy on BlockedFab give
+// the same result as on FArrayBox, and aborts if not.
+//
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_BlockedFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+
+using namespace amrex;
+
+namespace {
+    constexpr int URHO = 0;
+    constexpr int UMX  = 1;
+    constexpr int UMY  = 2;
+    constexpr int UMZ  = 3;
+    constexpr int UEDEN = 4;
+    constexpr int UFS  = 5;
+}
+
+template <class U, class Q>
+void eos (Box const& bx, U const& u, Q const& q, int nspec)
+{
+    amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+    {
+        const Real rho  = u(i,j,k,URHO);
+        const Real rinv = 1.0/rho;
+        const Real ke   = 0.5*rinv*(u(i,j,k,UMX)*u(i,j,k,UMX) +
+                                    u(i,j,k,UMY)*u(i,j,k,UMY) +
+                                    u(i,j,k,UMZ)*u(i,j,k,UMZ));
+        const Real e = (u(i,j,k,UEDEN) - ke) * rinv;
+        Real cv = 0.0, rgas = 0.0;
+        for (int n = 0; n < nspec; ++n) {
+            const Real Y = u(i,j,k,UFS+n) * rinv;
+            cv   += Y * (1.0 + 0.1*n);
+            rgas += Y * (0.4 + 0.01*n);
+        }
+        const Real T = e / cv;
+        const Real p = rho * rgas * T;
+        q(i,j,k,0) = p;
+        q(i,j,k,1) = std::sqrt((1.0 + rgas/cv) * p * rinv);
+    });
+}
+
+template <class FAB>
+double run (FabArray<FAB>& u, FabArray<FAB>& q, int nspec, int iters)
+{
+    const int ncomp = u.nComp();
+    for (MFIter mfi(u); mfi.isValid(); ++mfi)
+    {
+        auto const& a = u.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [=] (int i, int j, int k) noexcept
+        {
+            const Real rho = 1.0 + 0.001*(i+j+k);
+            a(i,j,k,URHO) = rho;
+            a(i,j,k,UMX) = 0.1*rho;
+            a(i,j,k,UMY) = 0.2*rho;
+            a(i,j,k,UMZ) = 0.3*rho;
+            a(i,j,k,UEDEN) = 10.0*rho;
+            for (int n = UFS; n < ncomp; ++n) {
+                a(i,j,k,n) = rho / (ncomp-UFS);
+            }
+        });
+    }
+
+    double timer = amrex::second();
+    for (int it = 0; it < iters; ++it)
+    {
+        for (MFIter mfi(u); mfi.isValid(); ++mfi)
+        {
+            eos(mfi.validbox(), u.const_array(mfi), q.array(mfi), nspec);
+        }
+    }
+    return amrex::second() - timer;
+}
+
+template <class FAB>
+void fill (FabArray<FAB>& fa, Real offset)
+{
+    fa.setVal(-1.0);
+    const int ncomp = fa.nComp();
+    for (MFIter mfi(fa); mfi.isValid(); ++mfi)
+    {
+        auto const& a = fa.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = i + 100.*j + 1.e4*k + 1.e6*n + offset;
+        });
+    }
+}
+
+template <int B>
+Real difference (const FabArray<BlockedFab<Real,B> >& bf, const MultiFab& mf)
+{
+    const int ncomp = mf.nComp();
+    MultiFab tmp(mf.boxArray(), mf.DistributionMap(), ncomp, mf.nGrow());
+    amrex::Copy(tmp, bf, 0, 0, ncomp, mf.nGrowVect());
+    MultiFab::Subtract(tmp, mf, 0, 0, ncomp, mf.nGrow());
+    Real diff = 0.0;
+    for (int n = 0; n < ncomp; ++n) {
+        diff = std::max(diff, tmp.norm0(n, mf.nGrow()));
+    }
+    return diff;
+}
+
+template <int B>
+void check_comm (const BoxArray& ba, const DistributionMapping& dm, int ncomp, int ng,
+                 const Periodicity& period)
+{
+    MultiFab mf(ba, dm, ncomp, ng);
+    FabArray<BlockedFab<Real,B> > bf(ba, dm, ncomp, ng);
+
+    fill(mf, 0.0);
+    fill(bf, 0.0);
+    mf.FillBoundary(period);
+    bf.FillBoundary(period);
+    const Real fb_diff = difference(bf, mf);
+
+    // A source with a different decomposition.
+    BoxArray ba2(ba.minimalBox());
+    ba2.maxSize(ba[0].longside()/2);
+    DistributionMapping dm2(ba2);
+    MultiFab src(ba2, dm2, ncomp, 0);
+    FabArray<BlockedFab<Real,B> > bsrc(ba2, dm2, ncomp, 0);
+    fill(src, 0.5);
+    fill(bsrc, 0.5);
+
+    mf.setVal(-1.0);
+    bf.setVal(-1.0);
+    mf.ParallelCopy(src, 0, 0, ncomp, 0, ng, period);
+    bf.ParallelCopy(bsrc, 0, 0, ncomp, 0, ng, period);
+    const Real pc_diff = difference(bf, mf);
+
+    amrex::Print() << "  BlockedFab<" << B << "> vs. FArrayBox: FillBoundary " << fb_diff
+                   << ", ParallelCopy " << pc_diff << std::endl;
+    if (fb_diff != 0.0 || pc_diff != 0.0) {
+        amrex::Abort("BlockedFab communication does not match FArrayBox");
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int iters = 20;
+        int boxsize = 64;
+        int max_grid_size = 32;
+        int nspec = 9;
+        {
+            ParmParse pp;
+            pp.query("iters", iters);
+            pp.query("boxsize", boxsize);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nspec", nspec);
+        }
+
+        BoxArray ba(Box(IntVect(0), IntVect(boxsize-1)));
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        const int ncomp = UFS + nspec;
+
+        amrex::Print() << "Mixture EOS on " << boxsize << "^3 cells, " << ncomp
+                       << " components, " << iters << " iterations" << std::endl;
+
+        MultiFab u(ba, dm, ncomp, 0), q(ba, dm, 2, 0);
+        const double t_plane = run(u, q, nspec, iters);
+        amrex::Print() << "  FArrayBox:     " << t_plane << " seconds" << std::endl;
+
+        FabArray<BlockedFab<Real,4> > u4(ba, dm, ncomp, 0), q4(ba, dm, 2, 0);
+        const double t_b4 = run(u4, q4, nspec, iters);
+        amrex::Print() << "  BlockedFab<4>: " << t_b4 << " seconds" << std::endl;
+
+        FabArray<BlockedFab<Real,8> > u8(ba, dm, ncomp, 0), q8(ba, dm, 2, 0);
+        const double t_b8 = run(u8, q8, nspec, iters);
+        amrex::Print() << "  BlockedFab<8>: " << t_b8 << " seconds" << std::endl;
+
+        FabArray<BlockedFab<Real,16> > u16(ba, dm, ncomp, 0), q16(ba, dm, 2, 0);
+        const double t_b16 = run(u16, q16, nspec, iters);
+        amrex::Print() << "  BlockedFab<16>: " << t_b16 << " seconds" << std::endl;
+
+        MultiFab q8c(ba, dm, 2, 0);
+        amrex::Copy(q8c, q8, 0, 0, 2, 0);
+        MultiFab::Subtract(q8c, q, 0, 0, 2, 0);
+        amrex::Print() << "  max difference: " << q8c.norm0(0) << " " << q8c.norm0(1) << std::endl;
+
+        const Periodicity period(IntVect(AMREX_D_DECL(boxsize,boxsize,boxsize)));
+        check_comm<4>(ba, dm, ncomp, 2, period);
+        check_comm<8>(ba, dm, ncomp, 2, period);
+    }
+    amrex::Finalize();
+}
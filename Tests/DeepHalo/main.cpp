@@ -0,0 +1,139 @@
+//
+// Runs a two-stage Runge-Kutta update of the heat equation with a
+// seven-point stencil, exchanging ghost cells with DeepHalo every k
+// stages, and checks that the result is bitwise equal to exchanging at
+// every stage, that the exchanges happen at every k-th stage only, and
+// that the ghost cells the skipped stages rely on agree with
+// FillBoundary.  Aborts on any failure.
+//
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_DeepHalo.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("DeepHalo: " + what);
+}
+
+// out = a*base + b*(u + dt*lap(u)) on bx
+void stage (const Box& bx, Array4<Real> const& out, Array4<Real const> const& u,
+            Array4<Real const> const& base, Real a, Real b, Real dt)
+{
+    amrex::LoopOnCpu(bx, [=] (int i, int j, int k)
+    {
+        const Real lap = AMREX_D_TERM(u(i-1,j,k) + u(i+1,j,k) - 2.0*u(i,j,k),
+                                      + u(i,j-1,k) + u(i,j+1,k) - 2.0*u(i,j,k),
+                                      + u(i,j,k-1) + u(i,j,k+1) - 2.0*u(i,j,k));
+        out(i,j,k) = a*base(i,j,k) + b*(u(i,j,k) + dt*lap);
+    });
+}
+
+//! Runs nsteps steps with nsweeps stages between exchanges and returns the solution.
+MultiFab run (int nsweeps, const BoxArray& ba, const DistributionMapping& dm, const Geometry& geom,
+              int nsteps)
+{
+    const std::string name = "k = " + std::to_string(nsweeps);
+    DeepHalo dh(nsweeps, IntVect(1));
+    check(dh.nGrow() == IntVect(nsweeps), name + ": nGrow");
+
+    MultiFab S(ba, dm, 1, dh.nGrow());
+    MultiFab S1(ba, dm, 1, dh.nGrow());
+    MultiFab Sn(ba, dm, 1, dh.nGrow());
+    for (MFIter mfi(S); mfi.isValid(); ++mfi) {
+        auto const& a = S.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [=] (int i, int j, int k)
+        {
+            a(i,j,k) = std::sin(0.3*i) * std::cos(0.2*j) + 0.01*k;
+        });
+    }
+
+    int istage = 0;
+    int nfills = 0;
+    for (int step = 0; step < nsteps; ++step)
+    {
+        if (dh.FillBoundary(S, istage, geom.periodicity())) {
+            ++nfills;
+        } else {
+            DeepHalo::checkGhostCells(S, dh.nGrowValid(istage), geom.periodicity());
+        }
+        for (MFIter mfi(S); mfi.isValid(); ++mfi) {
+            stage(mfi.growntilebox(dh.nGrowUpdate(istage)), S1.array(mfi),
+                  S.const_array(mfi), S.const_array(mfi), 0.0, 1.0, 0.1);
+        }
+        ++istage;
+
+        // The second stage also reads S, which needs its ghost cells
+        // exchanged whenever S1 does.
+        dh.FillBoundary(S, istage, geom.periodicity());
+        if (dh.FillBoundary(S1, istage, geom.periodicity())) {
+            ++nfills;
+        } else {
+            DeepHalo::checkGhostCells(S, dh.nGrowValid(istage), geom.periodicity());
+            DeepHalo::checkGhostCells(S1, dh.nGrowValid(istage), geom.periodicity());
+        }
+        for (MFIter mfi(S); mfi.isValid(); ++mfi) {
+            stage(mfi.growntilebox(dh.nGrowUpdate(istage)), Sn.array(mfi),
+                  S1.const_array(mfi), S.const_array(mfi), 0.5, 0.5, 0.1);
+        }
+        ++istage;
+
+        std::swap(S, Sn);
+    }
+
+    check(nfills == (2*nsteps + nsweeps - 1) / nsweeps, name + ": number of exchanges");
+
+    MultiFab r(ba, dm, 1, 0);
+    MultiFab::Copy(r, S, 0, 0, 1, 0);
+    return r;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 8;
+        int nsteps = 6;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nsteps", nsteps);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+        const Geometry geom(domain, RealBox({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)}),
+                            0, is_periodic);
+
+        const MultiFab ref = run(1, ba, dm, geom, nsteps);
+        for (int k : {2, 3, 4}) {
+            const MultiFab S = run(k, ba, dm, geom, nsteps);
+            bool same = true;
+            for (MFIter mfi(S); mfi.isValid(); ++mfi) {
+                same = same && std::memcmp(S[mfi].dataPtr(), ref[mfi].dataPtr(),
+                                           S[mfi].nBytes()) == 0;
+            }
+            ParallelDescriptor::ReduceBoolAnd(same);
+            check(same, "k = " + std::to_string(k) + ": bitwise equal to exchanging every stage");
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,107 @@
+//
+// Writes a MultiFab with VisMF and reads it back onto a BoxArray with a
+// different max_grid_size through direct reads, and aborts if a valid
+// cell is wrong or a ghost cell was filled.
+//
+// With mode = both, the read also uses a different number of processes,
+// because the DistributionMapping of the read leaves out the last one.
+// To restart on a different number of processes, run with mode = write,
+// then again with mode = read and another mpirun -np.
+//
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_VisMF.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+    const std::string mf_name("DirectReads_mf");
+
+    AMREX_FORCE_INLINE
+    Real value (int i, int j, int k, int n) noexcept
+    {
+        return i + 100.*j + 10000.*k + 1.e6*n;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        std::string mode("both");
+        int n_cell = 64;
+        int write_max_grid_size = 32;
+        int read_max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("mode", mode);
+            pp.query("n_cell", n_cell);
+            pp.query("write_max_grid_size", write_max_grid_size);
+            pp.query("read_max_grid_size", read_max_grid_size);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        const int ncomp = 3;
+
+        if (mode == "both" || mode == "write")
+        {
+            BoxArray ba(domain);
+            ba.maxSize(write_max_grid_size);
+            DistributionMapping dm(ba);
+            MultiFab mf(ba, dm, ncomp, 1);
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+            {
+                auto const& a = mf.array(mfi);
+                amrex::LoopOnCpu(mfi.fabbox(), ncomp, [=] (int i, int j, int k, int n) noexcept
+                {
+                    a(i,j,k,n) = value(i,j,k,n);
+                });
+            }
+            VisMF::Write(mf, mf_name);
+            amrex::Print() << "wrote " << ba.size() << " boxes on "
+                           << ParallelDescriptor::NProcs() << " processes\n";
+        }
+
+        if (mode == "both" || mode == "read")
+        {
+            BoxArray ba(domain);
+            ba.maxSize(read_max_grid_size);
+
+            const int nprocs = ParallelDescriptor::NProcs();
+            const int nread = (mode == "both" && nprocs > 1) ? nprocs-1 : nprocs;
+            Vector<int> pmap(ba.size());
+            for (int i = 0; i < ba.size(); ++i) {
+                pmap[i] = i % nread;
+            }
+            DistributionMapping dm(pmap);
+
+            const Real ghost = -1.0;
+            MultiFab mf(ba, dm, ncomp, 1);
+            mf.setVal(ghost);
+            VisMF::Read(mf, mf_name);
+
+            long nbad = 0;
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+            {
+                auto const& a = mf.const_array(mfi);
+                const Box& vbx = mfi.validbox();
+                amrex::LoopOnCpu(mfi.fabbox(), ncomp, [&] (int i, int j, int k, int n) noexcept
+                {
+                    const Real expected = vbx.contains(IntVect(AMREX_D_DECL(i,j,k)))
+                        ? value(i,j,k,n) : ghost;
+                    if (a(i,j,k,n) != expected) ++nbad;
+                });
+            }
+            ParallelDescriptor::ReduceLongSum(nbad);
+
+            amrex::Print() << "read " << ba.size() << " boxes on " << nread
+                           << " processes, " << nbad << " wrong cells\n";
+            if (nbad != 0) {
+                amrex::Abort("DirectReads: data read back differ from data written");
+            }
+        }
+    }
+    amrex::Finalize();
+}
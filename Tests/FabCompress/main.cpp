@@ -0,0 +1,167 @@
+//
+// Round trips arrays through FabCompress::Encode and Decode and checks
+// that lossless encodings are bitwise exact and lossy ones within their
+// tolerance, and that the quantization step is stored little endian.
+// Then writes a plotfile with plotfile.lossy_tolerance and checks each
+// variable read back with PlotFileData against its bound.  Aborts on any
+// failure.
+//
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_FabCompress.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("FabCompress: " + what);
+}
+
+std::string str (Real x)
+{
+    std::ostringstream os;
+    os << x;
+    return os.str();
+}
+
+void roundTrip (const std::string& name, const Vector<Real>& data, Real tolerance,
+                bool expect_lossy)
+{
+    Vector<char> buf(3, 'x');   // Encode appends
+    const std::size_t nbytes = FabCompress::Encode(data.data(), data.size(), tolerance, buf);
+    check(static_cast<Long>(nbytes) + 3 == buf.size(), name + " size");
+
+    const bool lossy = buf[3] != 0;
+    check(lossy == expect_lossy, name + " mode");
+
+    if (lossy) {
+        // The step is 2*(1-1.e-3)*tolerance, as the bits of a little-endian double.
+        const double step = 2.0*(1.0-1.e-3)*static_cast<double>(tolerance);
+        std::uint64_t bits;
+        std::memcpy(&bits, &step, sizeof(double));
+        bool le = true;
+        for (int b = 0; b < 8; ++b) {
+            le = le && static_cast<unsigned char>(buf[4+b]) == ((bits >> (8*b)) & 0xff);
+        }
+        check(le, name + " step bytes");
+    }
+
+    Vector<Real> out(data.size());
+    FabCompress::Decode(buf.data()+3, nbytes, out.data(), out.size());
+
+    if (lossy) {
+        Real err = 0.0;
+        for (int i = 0, N = data.size(); i < N; ++i) {
+            err = std::max(err, std::abs(out[i]-data[i]));
+        }
+        check(err <= tolerance, name + " max error " + str(err));
+    } else {
+        check(std::memcmp(out.data(), data.data(), data.size()*sizeof(Real)) == 0,
+              name + " bitwise");
+    }
+
+    amrex::Print() << "    " << data.size()*sizeof(Real) << " -> " << nbytes << " bytes\n";
+}
+
+void testCodec ()
+{
+    const int n = 10001;   // odd, for the last lossless pair
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<Real> dist(-1.0, 1.0);
+
+    Vector<Real> smooth(n), noisy(n), constant(n, 3.25), bad(n);
+    for (int i = 0; i < n; ++i) {
+        smooth[i] = std::sin(0.01*i) + 0.5*std::cos(0.003*i);
+        noisy[i]  = 1.e3*dist(gen);
+        bad[i]    = smooth[i];
+    }
+    bad[n/2] = std::numeric_limits<Real>::quiet_NaN();
+    const Vector<Real> empty;
+
+    roundTrip("smooth, exact", smooth, 0.0, false);
+    roundTrip("noisy, exact", noisy, 0.0, false);
+    roundTrip("constant, exact", constant, 0.0, false);
+    roundTrip("empty, exact", empty, 0.0, false);
+    for (Real tol : {Real(1.e-8), Real(1.e-4), Real(1.e-1)}) {
+        const std::string t = str(tol);
+        roundTrip("smooth, tolerance " + t, smooth, tol, true);
+        roundTrip("noisy, tolerance " + t, noisy, tol, true);
+        roundTrip("constant, tolerance " + t, constant, tol, true);
+    }
+    // Values that cannot be quantized fall back to the lossless encoding.
+    roundTrip("NaN, tolerance 0.0001", bad, 1.e-4, false);
+    roundTrip("noisy, tolerance 1e-12", noisy, 1.e-12, false);
+}
+
+void testPlotfile (int n_cell, int max_grid_size)
+{
+    const Box domain(IntVect(0), IntVect(n_cell-1));
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+    const Geometry geom(domain, RealBox({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)}),
+                        0, {AMREX_D_DECL(0,0,0)});
+
+    const Vector<std::string> names{"a", "b", "c"};
+    MultiFab mf(ba, dm, names.size(), 0);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), names.size(), [&] (int i, int j, int k, int c)
+        {
+            const Real x = (i+0.5)/n_cell, y = (j+0.5)/n_cell, z = (k+0.5)/n_cell;
+            a(i,j,k,c) = (c+1) * std::sin(6.*x) * std::cos(5.*y) * std::exp(-z);
+        });
+    }
+
+    WriteSingleLevelPlotfile("plt_fabcompress", mf, names, geom, 0.0, 0);
+
+    ParmParse pp("plotfile");
+    PlotFileData pf("plt_fabcompress");
+    for (int c = 0, N = names.size(); c < N; ++c)
+    {
+        Real tol = 0.0;
+        pp.query("lossy_tolerance", tol);
+        pp.query(("lossy_tolerance." + names[c]).c_str(), tol);
+
+        const MultiFab& disk = pf.get(0, names[c]);
+        MultiFab diff(ba, dm, 1, 0);
+        diff.ParallelCopy(disk);
+        MultiFab::Subtract(diff, mf, c, 0, 1, 0);
+        const Real err = diff.norm0();
+        check(err <= tol, "plotfile variable " + names[c] + " max error " + str(err)
+              + ", tolerance " + str(tol));
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        testCodec();
+        testPlotfile(n_cell, max_grid_size);
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,133 @@
+//
+// Times RealDescriptor conversions between native Reals and the IEEE
+// formats FABs are written in, and checks them against a scalar
+// byte swap and cast.  A memcpy of the same data is timed for reference.
+//
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_FabConv.H>
+#include <AMReX_FPC.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Vector.H>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+// The value of item i of a buffer in format rd, by a byte swap and a cast.
+double reference_value (const char* buf, long i, const RealDescriptor& rd)
+{
+    const int nb = rd.numBytes();
+    const bool swap = (rd.orderarray() != (nb == 4 ? FPC::Native32RealDescriptor()
+                                                   : FPC::Native64RealDescriptor()).orderarray());
+    char b[8];
+    for (int k = 0; k < nb; ++k) {
+        b[k] = buf[i*nb + (swap ? nb-1-k : k)];
+    }
+    if (nb == 4) {
+        float f;
+        std::memcpy(&f, b, 4);
+        return f;
+    } else {
+        double d;
+        std::memcpy(&d, b, 8);
+        return d;
+    }
+}
+
+double time_it (int iters, const std::function<void()>& f)
+{
+    f();
+    double tmin = 1.e200;
+    for (int it = 0; it < iters; ++it) {
+        double t = amrex::second();
+        f();
+        tmin = std::min(tmin, amrex::second() - t);
+    }
+    return tmin;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int iters = 20;
+        long nitems = 4194304;
+        {
+            ParmParse pp;
+            pp.query("iters", iters);
+            pp.query("nitems", nitems);
+        }
+
+        Vector<Real> src(nitems), dst(nitems);
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        for (auto& x : src) {
+            x = dist(gen);
+        }
+
+        Vector<char> buf(nitems*8);
+        const double mb = double(nitems*sizeof(Real)) / (1024.0*1024.0);
+
+        double t = time_it(iters, [&] () { std::memcpy(dst.data(), src.data(), nitems*sizeof(Real)); });
+        amrex::Print() << "memcpy                                  "
+                       << mb/t << " MB/s of native Reals\n";
+
+        const RealDescriptor* rds[] = { &FPC::Ieee64NormalRealDescriptor(),
+                                        &FPC::Ieee32NormalRealDescriptor(),
+                                        &FPC::Native64RealDescriptor(),
+                                        &FPC::Native32RealDescriptor() };
+        const char* names[] = { "IEEE64 big endian", "IEEE32 big endian",
+                                "native double", "native float" };
+
+        bool ok = true;
+        for (int r = 0; r < 4; ++r)
+        {
+            const RealDescriptor& rd = *rds[r];
+            if (rd == FPC::NativeRealDescriptor()) continue;
+
+            t = time_it(iters, [&] () {
+                RealDescriptor::convertFromNativeFormat(buf.data(), nitems, src.data(), rd);
+            });
+            amrex::Print() << "native Real -> " << names[r] << std::string(26-std::strlen(names[r]),' ')
+                           << mb/t << " MB/s of native Reals\n";
+
+            for (long i = 0; i < nitems; ++i) {
+                if (reference_value(buf.data(), i, rd) !=
+                    (rd.numBytes() == 4 ? double(float(src[i])) : double(src[i]))) {
+                    amrex::Print() << "  wrong value at " << i << "\n";
+                    ok = false;
+                    break;
+                }
+            }
+
+            t = time_it(iters, [&] () {
+                RealDescriptor::convertToNativeFormat(dst.data(), nitems, buf.data(), rd);
+            });
+            amrex::Print() << names[r] << " -> native Real" << std::string(26-std::strlen(names[r]),' ')
+                           << mb/t << " MB/s of native Reals\n";
+
+            for (long i = 0; i < nitems; ++i) {
+                if (double(dst[i]) != reference_value(buf.data(), i, rd)) {
+                    amrex::Print() << "  wrong value at " << i << "\n";
+                    ok = false;
+                    break;
+                }
+            }
+        }
+
+        if (!ok) {
+            amrex::Abort("FabConvBenchmark: conversions differ from the reference");
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,114 @@
+//
+// Spills a MultiFab with FabSpiller and checks that its FABs are freed
+// after finishSpills(), and that they are bitwise equal to a copy after
+// restore() or get().  Restoring right after spill(), while the writes
+// may still be running, is checked too.  Aborts on any failure.
+//
+#include <cstring>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_FabSpiller.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+long nonResident (const FabSpiller& spiller, const MultiFab& mf)
+{
+    long n = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        if (!spiller.isResident(mfi.LocalIndex()) && mf[mfi].dataPtr() == nullptr) ++n;
+    }
+    ParallelDescriptor::ReduceLongSum(n);
+    return n;
+}
+
+long difference (const MultiFab& mf, const MultiFab& ref)
+{
+    long n = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const FArrayBox& a = mf[mfi];
+        const FArrayBox& b = ref[mfi];
+        if (a.dataPtr() == nullptr || a.box() != b.box() || a.nComp() != b.nComp() ||
+            std::memcmp(a.dataPtr(), b.dataPtr(), b.nBytes()) != 0) {
+            ++n;
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(n);
+    return n;
+}
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("FabSpiller: " + what);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int ncomp = 4;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+        }
+
+        BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+        const DistributionMapping dm(ba);
+
+        MultiFab mf(ba, dm, ncomp, 1);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            auto const& a = mf.array(mfi);
+            amrex::LoopOnCpu(mfi.fabbox(), ncomp, [=] (int i, int j, int k, int n) noexcept
+            {
+                a(i,j,k,n) = std::sin(0.37*i + 0.11*j) * std::exp(0.01*k) + n;
+            });
+        }
+        MultiFab ref(ba, dm, ncomp, 1);
+        MultiFab::Copy(ref, mf, 0, 0, ncomp, 1);
+
+        const long nfabs = ba.size();
+        {
+            FabSpiller spiller(mf, "test");
+
+            spiller.spill();
+            spiller.finishSpills();
+            check(nonResident(spiller, mf) == nfabs, "FABs freed after finishSpills");
+
+            spiller.restore();
+            check(difference(mf, ref) == 0, "FABs equal after restore");
+
+            spiller.spill();
+            spiller.finishSpills();
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                spiller.prefetchAhead(mfi);
+                spiller.get(mfi);
+            }
+            check(difference(mf, ref) == 0, "FABs equal after get");
+
+            // ---- restore while the writes may still be running
+            spiller.spill();
+            spiller.restore();
+            check(difference(mf, ref) == 0, "FABs equal after restore during writes");
+
+            spiller.spill();
+            spiller.finishSpills();
+            spiller.PrintStats();
+        }
+        // ---- the destructor makes the FABs resident again
+        check(difference(mf, ref) == 0, "FABs equal after the spiller is destroyed");
+    }
+    amrex::Finalize();
+}
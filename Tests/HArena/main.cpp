@@ -0,0 +1,99 @@
+//
+// Checks HArena: hunks are rounded to and aligned on huge pages, freed
+// blocks are reused, data survive, explicit huge pages and the NUMA
+// policies fall back gracefully where the system lacks them, and the
+// reported huge page coverage is a fraction.  Then checks that
+// amrex.use_huge_page_arena makes The_Arena an HArena.  Aborts on any
+// failure.
+//
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_HArena.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("HArena: " + what);
+}
+
+bool onHugePage (void* p)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % HArena::HugePageSize == 0;
+}
+
+//! Allocates, fills and frees a few blocks, and returns whether all was well.
+bool exercise (HArena& a)
+{
+    std::vector<std::size_t> sizes = {100, 4096, 1000000, 3*HArena::HugePageSize + 5};
+    std::vector<double*> p;
+    for (std::size_t n : sizes) {
+        p.push_back(static_cast<double*>(a.alloc(n*sizeof(double))));
+        for (std::size_t i = 0; i < n; ++i) p.back()[i] = double(i) + n;
+    }
+    bool ok = true;
+    for (std::size_t k = 0; k < sizes.size(); ++k) {
+        for (std::size_t i = 0; i < sizes[k]; ++i) ok = ok && p[k][i] == double(i) + sizes[k];
+        a.free(p[k]);
+    }
+    const double coverage = a.hugePageCoverage();
+    return ok && coverage >= 0.0 && coverage <= 1.0;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        {
+            HArena a(1000);
+            void* p = a.alloc(64);
+            check(onHugePage(p) && a.heap_space_used() == std::size_t(HArena::HugePageSize),
+                  "hunks rounded to and aligned on huge pages");
+            a.free(p);
+            void* q = a.alloc(64);
+            check(p == q && a.heap_space_used() == std::size_t(HArena::HugePageSize),
+                  "freed blocks reused");
+            a.free(q);
+            check(exercise(a), "data survive, coverage is a fraction");
+        }
+
+        {
+            HArena a(HArena::DefaultHugeHunkSize, true);
+            check(exercise(a), "explicit huge pages or fallback");
+        }
+
+        check(HArena::numaPolicy("none") == HArena::NumaPolicy::none
+              && HArena::numaPolicy("bind") == HArena::NumaPolicy::bind
+              && HArena::numaPolicy("interleave") == HArena::NumaPolicy::interleave,
+              "NUMA policy names");
+        {
+            HArena a(HArena::DefaultHugeHunkSize, false, HArena::NumaPolicy::bind, 0);
+            check(exercise(a), "NUMA bind to node 0");
+        }
+        {
+            HArena a(HArena::DefaultHugeHunkSize, false, HArena::NumaPolicy::interleave);
+            check(exercise(a), "NUMA interleave");
+        }
+
+        HArena* h = dynamic_cast<HArena*>(The_Arena());
+        check(h != nullptr, "The_Arena is an HArena");
+        const Box domain(IntVect(0), IntVect(63));
+        BoxArray ba(domain);
+        ba.maxSize(32);
+        MultiFab mf(ba, DistributionMapping(ba), 2, 1);
+        mf.setVal(1.0);
+        check(mf.sum(1) == domain.d_numPts(), "MultiFab in The_Arena");
+        check(h->heap_space_used() == std::size_t(8*1024*1024), "amrex.huge_page_arena_hunk_size");
+    }
+    amrex::Finalize();
+}
@@ -66,6 +66,8 @@ static void PrintUsage(const char *progName) {
     cout << "   [nreadstreams      = nrs      ]" << '\n';
     cout << "   [usesingleread     = tf       ]" << '\n';
     cout << "   [usesinglewrite    = tf       ]" << '\n';
+    cout << "   [aggregatewrites   = tf       ]" << '\n';
+    cout << "   [aggregatorranks   = nranks   ]" << '\n';
     cout << "   [checkfpositions   = tf       ]" << '\n';
     cout << "   [checkfmf          = tf       ]" << '\n';
     cout << "   [pifstreams        = tf       ]" << '\n';
@@ -100,6 +102,8 @@ int main(int argc, char *argv[]) {
   bool filetests(false), dirtests(false);
   bool testreadmf(false);
   bool useSingleRead(false), useSingleWrite(false);
+  bool aggregateWrites(false);
+  int aggregatorRanks(0);
   bool checkFPositions(false), pIFStreams(false);
   bool checkmf(false);
   bool useDSS(false), useSyncReads(false);
@@ -136,6 +140,8 @@ int main(int argc, char *argv[]) {
   pp.query("setbuf", setBuf);
   pp.query("usesingleread", useSingleRead);
   pp.query("usesinglewrite", useSingleWrite);
+  pp.query("aggregatewrites", aggregateWrites);
+  pp.query("aggregatorranks", aggregatorRanks);
   pp.query("checkfpositions", checkFPositions);
   pp.query("checkmf", checkmf);
   pp.query("pifstreams", pIFStreams);
@@ -192,6 +198,8 @@ int main(int argc, char *argv[]) {
     cout << "nreadstreams      = " << nReadStreams << '\n';
     cout << "usesingleread     = " << useSingleRead << '\n';
     cout << "usesinglewrite    = " << useSingleWrite << '\n';
+    cout << "aggregatewrites   = " << aggregateWrites << '\n';
+    cout << "aggregatorranks   = " << aggregatorRanks << '\n';
     cout << "checkfpositions   = " << checkFPositions << '\n';
     cout << "checkmf           = " << checkmf << '\n';
     cout << "pifstreams        = " << pIFStreams << '\n';
@@ -329,6 +337,8 @@ int main(int argc, char *argv[]) {
 
   VisMF::SetUseSingleRead(useSingleRead);
   VisMF::SetUseSingleWrite(useSingleWrite);
+  VisMF::SetAggregateWrites(aggregateWrites);
+  VisMF::SetAggregatorRanks(aggregatorRanks);
   VisMF::SetCheckFilePositions(checkFPositions);
   VisMF::SetUsePersistentIFStreams(pIFStreams);
 
@@ -0,0 +1,312 @@
+//
+// Compares the C++ kernels of CellQuadratic (2D only),
+// CellConservativeProtected and CellConservativeQuartic with the Fortran
+// routines they replace, on every box of a fine level covering a
+// coarse level refined by 2.
+//
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_INTERP_F.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+
+using namespace amrex;
+
+namespace {
+
+// The old calling sequences of the Fortran routines.
+
+#if (AMREX_SPACEDIM == 2)
+void fortran_cqinterp (const FArrayBox& crse_in, int crse_comp, FArrayBox& fine, int fine_comp,
+                       int ncomp, const Box& fine_region, const IntVect& ratio,
+                       const Geometry& crse_geom, const Geometry& fine_geom,
+                       Vector<BCRec> const& bcr)
+{
+    Box target_fine_region = fine_region & fine.box();
+    Box crse_bx(amrex::coarsen(target_fine_region,ratio));
+    Box fslope_bx(amrex::refine(crse_bx,ratio));
+    Box cslope_bx(crse_bx);
+    cslope_bx.grow(1);
+
+    // The Fortran routine modifies the coarse data and needs them on cslope_bx exactly.
+    FArrayBox crse(cslope_bx, crse_in.nComp());
+    crse.copy(crse_in, cslope_bx);
+
+    int c_len = int(cslope_bx.numPts());
+    Vector<Real> cslope(5*c_len);
+    int loslp = cslope_bx.index(crse_bx.smallEnd());
+    int hislp = cslope_bx.index(crse_bx.bigEnd());
+    int clo = 1 - loslp;
+    int chi = clo + int(cslope_bx.numPts()) - 1;
+    c_len = hislp - loslp + 1;
+
+    int dir;
+    int f_len = fslope_bx.longside(dir);
+    Vector<Real> strip((5+2)*f_len);
+    Real* fstrip = strip.dataPtr();
+    Real* foff   = fstrip + f_len;
+    Real* fslope = foff + f_len;
+
+    Vector<Real> fvc[AMREX_SPACEDIM];
+    Vector<Real> cvc[AMREX_SPACEDIM];
+    for (dir = 0; dir < AMREX_SPACEDIM; dir++) {
+        fine_geom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
+        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
+    }
+
+    int slope_flag = 1;
+    int actual = 0;
+    Vector<int> bc = Interpolater::GetBCArray(bcr);
+    const int* ratioV = ratio.getVect();
+
+    amrex_cqinterp(fine.dataPtr(fine_comp), AMREX_ARLIM(fine.loVect()), AMREX_ARLIM(fine.hiVect()),
+                   AMREX_ARLIM(target_fine_region.loVect()), AMREX_ARLIM(target_fine_region.hiVect()),
+                   &ncomp, &ratioV[0], &ratioV[1],
+                   crse.dataPtr(crse_comp), &clo, &chi,
+                   AMREX_ARLIM(crse_bx.loVect()), AMREX_ARLIM(crse_bx.hiVect()),
+                   fslope_bx.loVect(), fslope_bx.hiVect(),
+                   cslope.dataPtr(), &c_len, fslope, fstrip, &f_len, foff,
+                   bc.dataPtr(), &slope_flag,
+                   fvc[0].dataPtr(), fvc[1].dataPtr(),
+                   cvc[0].dataPtr(), cvc[1].dataPtr(),
+                   &actual, &actual);
+}
+#endif
+
+void fortran_protect (const FArrayBox& crse, int crse_comp, FArrayBox& fine, int fine_comp,
+                      FArrayBox& fine_state, int state_comp, int ncomp,
+                      const Box& fine_region, const IntVect& ratio,
+                      const Geometry& crse_geom, const Geometry& fine_geom,
+                      Vector<BCRec> const& bcr)
+{
+    Box target_fine_region = fine_region & fine.box();
+    Box crse_bx = amrex::grow(amrex::coarsen(target_fine_region,ratio),1);
+    Box cs_bx = amrex::grow(crse_bx,-1);
+
+    Vector<int> bc = Interpolater::GetBCArray(bcr);
+    const int* ratioV = ratio.getVect();
+
+#if (AMREX_SPACEDIM == 2)
+    Vector<Real> fvc[AMREX_SPACEDIM];
+    Vector<Real> cvc[AMREX_SPACEDIM];
+    int cvcbhi[AMREX_SPACEDIM];
+    int fvcbhi[AMREX_SPACEDIM];
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+        fine_geom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
+        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
+        cvcbhi[dir] = crse_bx.smallEnd(dir) + cvc[dir].size() - 1;
+        fvcbhi[dir] = target_fine_region.smallEnd(dir) + fvc[dir].size() - 1;
+    }
+#else
+    amrex::ignore_unused(crse_geom);
+    amrex::ignore_unused(fine_geom);
+#endif
+
+    amrex_protect_interp(fine.dataPtr(fine_comp), AMREX_ARLIM(fine.loVect()), AMREX_ARLIM(fine.hiVect()),
+                         target_fine_region.loVect(), target_fine_region.hiVect(),
+                         crse.dataPtr(crse_comp), AMREX_ARLIM(crse.loVect()), AMREX_ARLIM(crse.hiVect()),
+                         cs_bx.loVect(), cs_bx.hiVect(),
+#if (AMREX_SPACEDIM == 2)
+                         fvc[0].dataPtr(), fvc[1].dataPtr(),
+                         AMREX_ARLIM(target_fine_region.loVect()), AMREX_ARLIM(fvcbhi),
+                         cvc[0].dataPtr(), cvc[1].dataPtr(),
+                         AMREX_ARLIM(crse_bx.loVect()), AMREX_ARLIM(cvcbhi),
+#endif
+                         fine_state.dataPtr(state_comp),
+                         AMREX_ARLIM(fine_state.loVect()), AMREX_ARLIM(fine_state.hiVect()),
+                         &ncomp, AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
+                         bc.dataPtr());
+}
+
+void fortran_quartic (const FArrayBox& crse, int crse_comp, FArrayBox& fine, int fine_comp,
+                      int ncomp, const Box& fine_region, const IntVect& ratio,
+                      Vector<BCRec> const& bcr)
+{
+    Box target_fine_region = fine_region & fine.box();
+    Box crse_bx = amrex::grow(amrex::coarsen(target_fine_region,ratio),2);
+    Box crse_bx2 = amrex::grow(crse_bx,-2);
+    Box fine_bx2 = amrex::refine(crse_bx2,ratio);
+
+    const int* cblo  = crse_bx.loVect();
+    const int* cbhi  = crse_bx.hiVect();
+
+    Vector<int> bc = Interpolater::GetBCArray(bcr);
+    const int* ratioV = ratio.getVect();
+    int actual = 0;
+
+    Vector<Real> ftmp(fine_bx2.length(0));
+#if (AMREX_SPACEDIM >= 2)
+    Vector<Real> ctmp((cbhi[0]-cblo[0]+1)*ratio[1]);
+#endif
+#if (AMREX_SPACEDIM == 3)
+    Vector<Real> ctmp2((cbhi[0]-cblo[0]+1)*(cbhi[1]-cblo[1]+1)*ratio[2]);
+#endif
+
+    amrex_quartinterp(fine.dataPtr(fine_comp), AMREX_ARLIM(fine.loVect()), AMREX_ARLIM(fine.hiVect()),
+                      target_fine_region.loVect(), target_fine_region.hiVect(),
+                      fine_bx2.loVect(), fine_bx2.hiVect(),
+                      crse.dataPtr(crse_comp), AMREX_ARLIM(crse.loVect()), AMREX_ARLIM(crse.hiVect()),
+                      cblo, cbhi, crse_bx2.loVect(), crse_bx2.hiVect(),
+                      &ncomp, AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
+                      AMREX_D_DECL(ftmp.dataPtr(), ctmp.dataPtr(), ctmp2.dataPtr()),
+                      bc.dataPtr(), &actual, &actual);
+}
+
+void fill (MultiFab& mf, const Geometry& geom, Real shift)
+{
+    const auto dx = geom.CellSizeArray();
+    const int ncomp = mf.nComp();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            Real x = 0.0, y = 0.0, z = 0.0;
+            AMREX_D_TERM(x = (i+0.5)*dx[0];,
+                         y = (j+0.5)*dx[1];,
+                         z = (k+0.5)*dx[2];)
+            a(i,j,k,n) = shift + std::sin(6.0*x + (n+1)*y) * std::cos(4.0*z + n*x);
+        });
+    }
+}
+
+template <class F>
+double time_it (MultiFab& fine, int iters, F&& f)
+{
+    double timer = amrex::second();
+    for (int it = 0; it < iters; ++it) {
+        for (MFIter mfi(fine); mfi.isValid(); ++mfi) {
+            f(mfi);
+        }
+    }
+    return amrex::second() - timer;
+}
+
+Real max_diff (const MultiFab& a, const MultiFab& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), 0);
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), 0);
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), 0);
+    Real m = 0.0;
+    for (int n = 0; n < a.nComp(); ++n) {
+        m = std::max(m, d.norm0(n));
+    }
+    return m;
+}
+
+void report (const std::string& name, double t_f, double t_c, Real diff)
+{
+    amrex::Print() << "  " << name << ": Fortran " << t_f << " s, C++ " << t_c
+                   << " s, max difference " << diff << std::endl;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int iters = 20;
+        int ncell = 256;
+        int max_grid_size = 32;
+        int ncomp = 4;
+        int coord = 0;
+        {
+            ParmParse pp;
+            pp.query("iters", iters);
+            pp.query("ncell", ncell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+            pp.query("coord", coord);
+        }
+
+        const IntVect ratio(2);
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        const Box fdomain(IntVect(0), IntVect(ncell-1));
+        const Box cdomain = amrex::coarsen(fdomain, ratio);
+        Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(0,0,0)};
+        const Geometry fgeom(fdomain, rb, coord, is_per);
+        const Geometry cgeom(cdomain, rb, coord, is_per);
+
+        BoxArray fba(fdomain);
+        fba.maxSize(max_grid_size);
+        DistributionMapping dm(fba);
+
+        // Coarse data under every fine box, with ghost cells for the widest stencil.
+        BoxArray cba = fba;
+        cba.coarsen(ratio);
+        MultiFab crse(cba, dm, ncomp, 2);
+        fill(crse, cgeom, 0.0);
+
+        // Boundary conditions that use the one-sided slopes.
+        Vector<BCRec> bcr(ncomp);
+        for (auto& bc : bcr) {
+            for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                bc.setLo(dir, BCType::ext_dir);
+                bc.setHi(dir, BCType::hoextrap);
+            }
+        }
+
+        MultiFab ffort(fba, dm, ncomp, 0);
+        MultiFab fcpp (fba, dm, ncomp, 0);
+
+        amrex::Print() << "Interpolation to " << ncell << "^" << AMREX_SPACEDIM << " cells, "
+                       << ncomp << " components, " << iters << " iterations, coord = "
+                       << coord << std::endl;
+
+#if (AMREX_SPACEDIM == 2)
+        {
+            const double t_f = time_it(ffort, iters, [&] (MFIter const& mfi) {
+                fortran_cqinterp(crse[mfi], 0, ffort[mfi], 0, ncomp, mfi.validbox(), ratio,
+                                 cgeom, fgeom, bcr);
+            });
+            const double t_c = time_it(fcpp, iters, [&] (MFIter const& mfi) {
+                quadratic_interp.interp(crse[mfi], 0, fcpp[mfi], 0, ncomp, mfi.validbox(), ratio,
+                                        cgeom, fgeom, bcr, 0, 0, RunOn::Cpu);
+            });
+            report("CellQuadratic", t_f, t_c, max_diff(ffort, fcpp));
+        }
+#endif
+
+        {
+            const double t_f = time_it(ffort, iters, [&] (MFIter const& mfi) {
+                fortran_quartic(crse[mfi], 0, ffort[mfi], 0, ncomp, mfi.validbox(), ratio, bcr);
+            });
+            const double t_c = time_it(fcpp, iters, [&] (MFIter const& mfi) {
+                quartic_interp.interp(crse[mfi], 0, fcpp[mfi], 0, ncomp, mfi.validbox(), ratio,
+                                      cgeom, fgeom, bcr, 0, 0, RunOn::Cpu);
+            });
+            report("CellConservativeQuartic", t_f, t_c, max_diff(ffort, fcpp));
+        }
+
+        if (ncomp >= 3)
+        {
+            // A correction of either sign on a state that is small somewhere.
+            MultiFab state(fba, dm, ncomp, 0);
+            fill(state, fgeom, 0.2);
+            MultiFab corr(fba, dm, ncomp, 0);
+            fill(corr, fgeom, -0.1);
+
+            double t_f = 0.0, t_c = 0.0;
+            for (int it = 0; it < iters; ++it)
+            {
+                MultiFab::Copy(ffort, corr, 0, 0, ncomp, 0);
+                MultiFab::Copy(fcpp , corr, 0, 0, ncomp, 0);
+                t_f += time_it(ffort, 1, [&] (MFIter const& mfi) {
+                    fortran_protect(crse[mfi], 0, ffort[mfi], 0, state[mfi], 0, ncomp,
+                                    mfi.validbox(), ratio, cgeom, fgeom, bcr);
+                });
+                t_c += time_it(fcpp, 1, [&] (MFIter const& mfi) {
+                    protected_interp.protect(crse[mfi], 0, fcpp[mfi], 0, state[mfi], 0, ncomp,
+                                             mfi.validbox(), ratio, cgeom, fgeom, bcr,
+                                             RunOn::Cpu);
+                });
+            }
+            report("CellConservativeProtected", t_f, t_c, max_diff(ffort, fcpp));
+        }
+    }
+    amrex::Finalize();
+}
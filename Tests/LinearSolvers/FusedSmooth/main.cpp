@@ -0,0 +1,167 @@
+//
+// Solves with MLPoisson, MLABecLaplacian and MLNodeLaplacian with
+// MLLinOp::setFusedSmooth on and off, using the smoother as the bottom
+// solver and a fixed number of V-cycles, and checks that the solutions
+// are bitwise equal.  Also checks that mg.fused_smooth sets the default.
+// Aborts on any failure.
+//
+#include <cmath>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLMG.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLNodeLaplacian.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("FusedSmooth: " + what);
+}
+
+bool same (const MultiFab& a, const MultiFab& b)
+{
+    long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& x = a.const_array(mfi);
+        auto const& y = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+        {
+            if (x(i,j,k) != y(i,j,k)) ++ndiff;
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff == 0;
+}
+
+void fill (MultiFab& mf, Real a, Real b, Real c)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& f = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+        {
+            f(i,j,k) = 1.0 + 0.5*std::sin(a*i + b*j) * std::cos(c*k);
+        });
+    }
+}
+
+// Mixed boundary conditions, so that applyBC has work to do on every face.
+const Array<LinOpBCType,AMREX_SPACEDIM> lobc{AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                          LinOpBCType::Neumann,
+                                                          LinOpBCType::Dirichlet)};
+const Array<LinOpBCType,AMREX_SPACEDIM> hibc{AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                                          LinOpBCType::Dirichlet,
+                                                          LinOpBCType::Neumann)};
+
+//! Solves with op and returns the solution.
+MultiFab solve (MLLinOp& op, const BoxArray& ba, const DistributionMapping& dm, int niters)
+{
+    MultiFab rhs(ba, dm, 1, 0), sol(ba, dm, 1, 1);
+    fill(rhs, 0.1, 0.2, 0.05);
+    sol.setVal(0.0);
+    MLMG mlmg(op);
+    mlmg.setVerbose(0);
+    mlmg.setBottomSolver(MLMG::BottomSolver::smoother);
+    mlmg.setFixedIter(niters);
+    mlmg.solve({&sol}, {&rhs}, 1.e-30, 0.0);
+    MultiFab r(ba, dm, 1, 0);
+    MultiFab::Copy(r, sol, 0, 0, 1, 0);
+    return r;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int niters = 4;
+        int fused_default = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("niters", niters);
+            ParmParse ppmg("mg");
+            ppmg.query("fused_smooth", fused_default);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        const RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        const Geometry geom(domain, &rb, 0);
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        {
+            MLPoisson op({geom}, {ba}, {dm});
+            check(op.getFusedSmooth() == (fused_default != 0), "mg.fused_smooth sets the default");
+        }
+
+        {
+            MultiFab x[2];
+            for (int fused = 0; fused < 2; ++fused) {
+                MLPoisson op({geom}, {ba}, {dm});
+                op.setFusedSmooth(fused);
+                op.setDomainBC(lobc, hibc);
+                op.setLevelBC(0, nullptr);
+                x[fused] = solve(op, ba, dm, niters);
+            }
+            check(same(x[0], x[1]), "MLPoisson");
+        }
+
+        for (int maxorder : {2, 3})
+        {
+            MultiFab acoef(ba, dm, 1, 0);
+            fill(acoef, 0.3, 0.1, 0.2);
+            Array<MultiFab,AMREX_SPACEDIM> bcoef;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                bcoef[idim].define(amrex::convert(ba,IntVect::TheDimensionVector(idim)), dm, 1, 0);
+                fill(bcoef[idim], 0.3, 0.1*(idim+1), 0.07);
+            }
+
+            MultiFab x[2];
+            for (int fused = 0; fused < 2; ++fused) {
+                MLABecLaplacian op({geom}, {ba}, {dm});
+                op.setFusedSmooth(fused);
+                op.setMaxOrder(maxorder);
+                op.setDomainBC(lobc, hibc);
+                op.setLevelBC(0, nullptr);
+                op.setScalars(1.0, 1.0);
+                op.setACoeffs(0, acoef);
+                op.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+                x[fused] = solve(op, ba, dm, niters);
+            }
+            check(same(x[0], x[1]), "MLABecLaplacian with max order " + std::to_string(maxorder));
+        }
+
+        {
+            const BoxArray nba = amrex::convert(ba, IntVect::TheNodeVector());
+            MultiFab sigma(ba, dm, 1, 1);
+            sigma.setVal(1.0);
+            fill(sigma, 0.3, 0.1, 0.2);
+
+            MultiFab x[2];
+            for (int fused = 0; fused < 2; ++fused) {
+                MLNodeLaplacian op({geom}, {ba}, {dm});
+                op.setFusedSmooth(fused);
+                op.setGaussSeidel(true);
+                op.setDomainBC(lobc, hibc);
+                op.setSigma(0, sigma);
+                x[fused] = solve(op, nba, dm, niters);
+            }
+            check(same(x[0], x[1]), "MLNodeLaplacian");
+        }
+    }
+    amrex::Finalize();
+}
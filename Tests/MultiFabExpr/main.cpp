@@ -0,0 +1,139 @@
+//
+// Evaluates MultiFab expressions with operator=, Assign, Dot and
+// AssignAndDot, and compares them with the same arithmetic done by
+// MultiFab::LinComb, Saxpy and Dot.  Assignments must be bitwise equal;
+// dot products, whose summation order may differ, must agree to rounding.
+// Aborts on any failure.
+//
+#include <cmath>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabExpr.H>
+#include <AMReX_Random.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("MultiFabExpr: " + what);
+}
+
+void fillRandom (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), mf.nComp(), [&] (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = amrex::Random() - 0.5;
+        });
+    }
+}
+
+//! Whether components [comp,comp+ncomp) of a and b are bitwise equal on nghost ghost cells.
+bool same (const MultiFab& a, const MultiFab& b, int comp, int ncomp, int nghost)
+{
+    long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& x = a.const_array(mfi);
+        auto const& y = b.const_array(mfi);
+        amrex::LoopOnCpu(amrex::grow(mfi.validbox(),nghost), ncomp, [&] (int i, int j, int k, int n)
+        {
+            if (x(i,j,k,comp+n) != y(i,j,k,comp+n)) ++ndiff;
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff == 0;
+}
+
+bool close (Real a, Real b)
+{
+    return std::abs(a-b) <= 1.e-12 * std::max(std::abs(a), std::abs(b));
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const int ncomp = 3;
+        const int ng = 1;
+        MultiFab x(ba, dm, ncomp, ng), y(ba, dm, ncomp, ng), z(ba, dm, ncomp, ng);
+        MultiFab a(ba, dm, ncomp, ng), ref(ba, dm, ncomp, ng), tmp(ba, dm, ncomp, ng);
+        amrex::InitRandom(1234 + ParallelDescriptor::MyProc());
+        fillRandom(x);
+        fillRandom(y);
+        fillRandom(z);
+
+        const Real alpha = 0.7, beta = -1.3;
+
+        a.setVal(0.0);
+        a = alpha*x + beta*y;
+        MultiFab::LinComb(ref, alpha, x, 0, beta, y, 0, 0, ncomp, 0);
+        check(same(a, ref, 0, ncomp, 0), "operator= equals LinComb");
+
+        a.setVal(0.0);
+        Assign(a, 0, alpha*x + beta*y, ncomp, ng);
+        MultiFab::LinComb(ref, alpha, x, 0, beta, y, 0, 0, ncomp, ng);
+        check(same(a, ref, 0, ncomp, ng), "Assign with ghost cells equals LinComb");
+
+        // a[1:3] = x[1:3] + alpha*y[0:2]
+        MultiFab::Copy(a, x, 0, 0, ncomp, ng);
+        MultiFab::Copy(ref, x, 0, 0, ncomp, ng);
+        Assign(a, 1, MFComp(x,1) + alpha*MFComp(y,0), 2, ng);
+        MultiFab::Saxpy(ref, alpha, y, 0, 1, 2, ng);
+        check(same(a, ref, 0, ncomp, ng), "Assign of components equals Saxpy");
+
+        Real d1 = Dot(alpha*x + beta*y, z, ncomp, 0);
+        MultiFab::LinComb(tmp, alpha, x, 0, beta, y, 0, 0, ncomp, 0);
+        Real d2 = MultiFab::Dot(tmp, 0, z, 0, ncomp, 0);
+        check(close(d1, d2), "Dot equals LinComb and MultiFab::Dot");
+
+        d1 = Dot(x, y, ncomp, ng);
+        d2 = MultiFab::Dot(x, 0, y, 0, ncomp, ng);
+        check(close(d1, d2), "Dot with ghost cells equals MultiFab::Dot");
+
+        // A residual update and its squared norm, r = r - alpha*y.
+        MultiFab::Copy(a, z, 0, 0, ncomp, ng);
+        MultiFab::Copy(ref, z, 0, 0, ncomp, ng);
+        d1 = AssignAndDot(a, 0, a - alpha*y, a, ncomp);
+        MultiFab::Saxpy(ref, -alpha, y, 0, 0, ncomp, 0);
+        d2 = MultiFab::Dot(ref, 0, ncomp, 0);
+        check(same(a, ref, 0, ncomp, 0) && close(d1, d2),
+              "AssignAndDot equals Saxpy and MultiFab::Dot");
+
+        d1 = AssignAndDot(a, 0, x*y/(z*z + 1.0), x, ncomp);
+        for (MFIter mfi(ref); mfi.isValid(); ++mfi) {
+            auto const& r = ref.array(mfi);
+            auto const& xa = x.const_array(mfi);
+            auto const& ya = y.const_array(mfi);
+            auto const& za = z.const_array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), ncomp, [&] (int i, int j, int k, int n)
+            {
+                r(i,j,k,n) = xa(i,j,k,n)*ya(i,j,k,n) / (za(i,j,k,n)*za(i,j,k,n) + 1.0);
+            });
+        }
+        d2 = MultiFab::Dot(ref, 0, x, 0, ncomp, 0);
+        check(same(a, ref, 0, ncomp, 0) && close(d1, d2), "AssignAndDot of a quotient");
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,371 @@
+//
+// Runs a two-level Amr with particles and amr.checkpoint_async, restarts
+// from a checkpoint written in the background, and checks that the state
+// and the particles at the last step are bitwise equal to those of the
+// first run.  The particles are written with
+// ParticleContainer::CheckpointAsync into Amr::asyncCheckPointWrites(),
+// and the last checkpoint is finished with Amr::finishAsyncCheckPoint.
+// Aborts on any failure.
+//
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_Amr.H>
+#include <AMReX_AmrLevel.H>
+#include <AMReX_LevelBld.H>
+#include <AMReX_AmrParticles.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_Utility.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PROB_AMR_F.H>
+
+using namespace amrex;
+
+extern "C"
+{
+    void amrex_probinit (const int* /*init*/, const int* /*name*/, const int* /*namelen*/,
+                         const amrex_real* /*problo*/, const amrex_real* /*probhi*/)
+    {}
+}
+
+namespace {
+
+using PC = AmrParticleContainer<1,1,1,1>;
+
+std::unique_ptr<PC> particles;
+
+//! The particles live on the levels of amr, as they are when this is called.
+PC* makeParticles (Amr& amr)
+{
+    Vector<Geometry> geom;
+    Vector<DistributionMapping> dmap;
+    Vector<BoxArray> ba;
+    Vector<int> rr;
+    for (int lev = 0; lev <= amr.finestLevel(); ++lev) {
+        geom.push_back(amr.Geom(lev));
+        dmap.push_back(amr.DistributionMap(lev));
+        ba.push_back(amr.boxArray(lev));
+        if (lev < amr.finestLevel()) rr.push_back(amr.refRatio(lev)[0]);
+    }
+    return new PC(geom, dmap, ba, rr);
+}
+
+void nullfill (Box const& /*bx*/, FArrayBox& /*data*/, const int /*dcomp*/, const int /*numcomp*/,
+               Geometry const& /*geom*/, const Real /*time*/, const Vector<BCRec>& /*bcr*/,
+               const int /*bcomp*/, const int /*scomp*/)
+{}
+
+}
+
+//
+// One state variable updated pointwise, and particles owned by level 0.
+//
+class TestLevel
+    :
+    public AmrLevel
+{
+public:
+
+    TestLevel () {}
+
+    TestLevel (Amr& papa, int lev, const Geometry& level_geom, const BoxArray& bl,
+               const DistributionMapping& dm, Real time)
+        : AmrLevel(papa, lev, level_geom, bl, dm, time) {}
+
+    static void variableSetUp ()
+    {
+        desc_lst.addDescriptor(0, IndexType::TheCellType(), StateDescriptor::Point, 0, 1,
+                               &cell_cons_interp);
+        int lo_bc[AMREX_SPACEDIM], hi_bc[AMREX_SPACEDIM];
+        for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+            lo_bc[i] = hi_bc[i] = BCType::int_dir;
+        }
+        desc_lst.setComponent(0, 0, "phi", BCRec(lo_bc, hi_bc),
+                              StateDescriptor::BndryFunc(nullfill));
+    }
+
+    static void variableCleanUp ()
+    {
+        desc_lst.clear();
+        particles.reset();
+    }
+
+    virtual void checkPoint (const std::string& dir, std::ostream& os, VisMF::How how,
+                             bool dump_old) override
+    {
+        AmrLevel::checkPoint(dir, os, how, dump_old);
+        if (level == 0) {
+            auto writes = parent->asyncCheckPointWrites();
+            AMREX_ALWAYS_ASSERT(writes != nullptr);
+            writes->push_back(particles->CheckpointAsync(dir, "P"));
+        }
+    }
+
+    virtual void computeInitialDt (int finest_level, int /*sub_cycle*/, Vector<int>& /*n_cycle*/,
+                                   const Vector<IntVect>& ref_ratio, Vector<Real>& dt_level,
+                                   Real /*stop_time*/) override
+    {
+        if (level > 0) return;
+        dt_level[0] = 0.01;
+        for (int i = 1; i <= finest_level; ++i) {
+            dt_level[i] = dt_level[i-1] / ref_ratio[i-1][0];
+        }
+    }
+
+    virtual void computeNewDt (int finest_level, int sub_cycle, Vector<int>& n_cycle,
+                               const Vector<IntVect>& ref_ratio, Vector<Real>& /*dt_min*/,
+                               Vector<Real>& dt_level, Real stop_time,
+                               int /*post_regrid_flag*/) override
+    {
+        computeInitialDt(finest_level, sub_cycle, n_cycle, ref_ratio, dt_level, stop_time);
+    }
+
+    virtual Real advance (Real time, Real dt, int /*iteration*/, int /*ncycle*/) override
+    {
+        for (int k = 0; k < desc_lst.size(); ++k) {
+            state[k].allocOldData();
+            state[k].swapTimeLevels(dt);
+        }
+        MultiFab& S_new = get_new_data(0);
+        const MultiFab& S_old = get_old_data(0);
+        for (MFIter mfi(S_new); mfi.isValid(); ++mfi) {
+            auto const& snew = S_new.array(mfi);
+            auto const& sold = S_old.const_array(mfi);
+            const int lev = level;
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+            {
+                snew(i,j,k) = sold(i,j,k)*(1.0-dt) + dt*std::sin(time + 0.1*i + 0.2*j + 0.3*k + lev);
+            });
+        }
+        return dt;
+    }
+
+    virtual void post_timestep (int /*iteration*/) override
+    {
+        if (level > 0) return;
+        const Real dt = parent->dtLevel(0);
+        for (int lev = 0; lev <= particles->finestLevel(); ++lev) {
+            for (PC::ParIterType pti(*particles, lev); pti.isValid(); ++pti) {
+                auto& aos = pti.GetArrayOfStructs();
+                auto& soa = pti.GetStructOfArrays();
+                for (int i = 0, N = aos.size(); i < N; ++i) {
+                    auto& p = aos[i];
+                    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                        p.pos(d) += 0.3*dt*(d+1);
+                    }
+                    p.rdata(0) += dt;
+                    p.idata(0) += 1;
+                    soa.GetRealData(0)[i] *= 1.0 + dt;
+                    soa.GetIntData(0)[i] -= 1;
+                }
+            }
+        }
+        particles->Redistribute();
+    }
+
+    virtual void post_regrid (int /*lbase*/, int /*new_finest*/) override {}
+
+    virtual void post_init (Real /*stop_time*/) override
+    {
+        if (level > 0) return;
+        particles.reset(makeParticles(*parent));
+        PC::ParticleInitData pdata = {{1.0}, {3}, {4.0}, {5}};
+        particles->InitRandom(10000, 451, pdata);
+    }
+
+    virtual void post_restart () override
+    {
+        if (level > 0) return;
+        particles.reset(makeParticles(*parent));
+        particles->Restart(parent->theRestartFile(), "P");
+    }
+
+    virtual void initData () override
+    {
+        get_new_data(0).setVal(1.0 + level);
+    }
+
+    virtual void init (AmrLevel& old) override
+    {
+        const Real dt_new    = parent->dtLevel(level);
+        const Real cur_time  = old.get_state_data(0).curTime();
+        const Real prev_time = old.get_state_data(0).prevTime();
+        setTimeLevel(cur_time, cur_time-prev_time, dt_new);
+        FillPatch(old, get_new_data(0), 0, cur_time, 0, 0, 1);
+    }
+
+    virtual void init () override
+    {
+        const Real dt        = parent->dtLevel(level);
+        const Real cur_time  = parent->getLevel(level-1).get_state_data(0).curTime();
+        const Real prev_time = parent->getLevel(level-1).get_state_data(0).prevTime();
+        setTimeLevel(cur_time, (cur_time-prev_time)/parent->MaxRefRatio(level-1), dt);
+        FillCoarsePatch(get_new_data(0), 0, cur_time, 0, 0, 1);
+    }
+
+    // The fine level covers the middle of the domain.
+    virtual void errorEst (TagBoxArray& tags, int /*clearval*/, int tagval, Real /*time*/,
+                           int /*n_error_buf*/, int /*ngrow*/) override
+    {
+        const Box middle = amrex::refine(Box(IntVect(8), IntVect(23)), 1 << level);
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+            auto const& t = tags.array(mfi);
+            amrex::LoopOnCpu(mfi.validbox() & middle, [&] (int i, int j, int k)
+            {
+                t(i,j,k) = tagval;
+            });
+        }
+    }
+};
+
+class TestLevelBld
+    :
+    public LevelBld
+{
+    virtual void variableSetUp () override { TestLevel::variableSetUp(); }
+    virtual void variableCleanUp () override { TestLevel::variableCleanUp(); }
+    virtual AmrLevel* operator() () override { return new TestLevel; }
+    virtual AmrLevel* operator() (Amr& papa, int lev, const Geometry& level_geom,
+                                  const BoxArray& ba, const DistributionMapping& dm,
+                                  Real time) override
+    {
+        return new TestLevel(papa, lev, level_geom, ba, dm, time);
+    }
+};
+
+TestLevelBld test_bld;
+
+LevelBld* getLevelBld ()
+{
+    return &test_bld;
+}
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("AsyncCheckpoint: " + what);
+}
+
+//! The state and particles of a run at its last step.
+struct Result
+{
+    Vector<std::unique_ptr<MultiFab> > state;
+    //! The fields of all particles, gathered on the I/O process and sorted.
+    std::vector<std::vector<char> > parts;
+    Long nparticles = 0;
+};
+
+void run (int max_step, Result& result)
+{
+    Amr amr;
+    amr.init(0.0, 1.e10);
+    while (amr.levelSteps(0) < max_step) {
+        amr.coarseTimeStep(1.e10);
+    }
+    amr.finishAsyncCheckPoint();
+
+    for (int lev = 0; lev <= amr.finestLevel(); ++lev) {
+        const MultiFab& S = amr.getLevel(lev).get_new_data(0);
+        result.state.emplace_back(new MultiFab(S.boxArray(), S.DistributionMap(), 1, 0));
+        MultiFab::Copy(*result.state.back(), S, 0, 0, 1, 0);
+    }
+
+    // Particles may live on other processes after a restart, so they are
+    // gathered on the I/O process.
+    std::vector<char> local;
+    const int nr = AMREX_SPACEDIM + 2;
+    const int ni = 4;
+    const int record = nr*sizeof(Real) + ni*sizeof(int);
+    for (int lev = 0; lev <= particles->finestLevel(); ++lev) {
+        for (PC::ParIterType pti(*particles, lev); pti.isValid(); ++pti) {
+            auto& aos = pti.GetArrayOfStructs();
+            auto& soa = pti.GetStructOfArrays();
+            for (int i = 0, N = aos.size(); i < N; ++i) {
+                // The fields one by one, because the struct has padding.
+                const auto& p = aos[i];
+                const int n[ni] = {p.id(), p.cpu(), p.idata(0), soa.GetIntData(0)[i]};
+                const Real r[nr] = {AMREX_D_DECL(p.pos(0), p.pos(1), p.pos(2)),
+                                    p.rdata(0), soa.GetRealData(0)[i]};
+                const char* cn = reinterpret_cast<const char*>(n);
+                const char* cr = reinterpret_cast<const char*>(r);
+                local.insert(local.end(), cn, cn + sizeof(n));
+                local.insert(local.end(), cr, cr + sizeof(r));
+            }
+        }
+    }
+
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+    const std::vector<int> counts = ParallelDescriptor::Gather(static_cast<int>(local.size()), IOProc);
+    std::vector<int> disp(counts.size(), 0);
+    for (int i = 1; i < static_cast<int>(counts.size()); ++i) disp[i] = disp[i-1] + counts[i-1];
+    std::vector<char> all(ParallelDescriptor::IOProcessor() ? disp.back() + counts.back() : 0);
+    ParallelDescriptor::Gatherv(local.data(), static_cast<int>(local.size()), all.data(),
+                                counts, disp, IOProc);
+    for (std::size_t i = 0; i < all.size(); i += record) {
+        result.parts.emplace_back(all.begin() + i, all.begin() + i + record);
+    }
+    std::sort(result.parts.begin(), result.parts.end());
+    result.nparticles = particles->TotalNumberOfParticles();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int max_step = 8;
+        int restart_step = 4;
+        std::string check_file = "chk";
+        {
+            ParmParse pp;
+            pp.query("max_step", max_step);
+            pp.query("restart_step", restart_step);
+            ParmParse ppa("amr");
+            ppa.query("check_file", check_file);
+        }
+        const std::string restart_file = amrex::Concatenate(check_file, restart_step, 5);
+        const std::string last_file = amrex::Concatenate(check_file, max_step, 5);
+
+        Result a, b;
+        run(max_step, a);
+
+        // All checkpoints have been renamed into place.
+        check(amrex::FileExists(restart_file) && amrex::FileExists(last_file)
+              && !amrex::FileExists(last_file + ".temp"), "checkpoints finished");
+
+        {
+            ParmParse ppa("amr");
+            ppa.add("restart", restart_file);
+            ppa.add("check_file", check_file + "_restart");
+        }
+        run(max_step, b);
+
+        check(a.nparticles > 0 && a.nparticles == b.nparticles, "number of particles");
+
+        bool same = a.state.size() == b.state.size();
+        for (int lev = 0; same && lev < static_cast<int>(a.state.size()); ++lev) {
+            same = a.state[lev]->boxArray() == b.state[lev]->boxArray();
+            if (same) {
+                MultiFab bb(a.state[lev]->boxArray(), a.state[lev]->DistributionMap(), 1, 0);
+                bb.ParallelCopy(*b.state[lev]);
+                for (MFIter mfi(bb); mfi.isValid(); ++mfi) {
+                    same = same && std::memcmp(bb[mfi].dataPtr(), (*a.state[lev])[mfi].dataPtr(),
+                                               bb[mfi].nBytes()) == 0;
+                }
+            }
+        }
+        ParallelDescriptor::ReduceBoolAnd(same);
+        check(same, "state bitwise equal after restart");
+
+        bool psame = a.parts == b.parts;
+        ParallelDescriptor::ReduceBoolAnd(psame);
+        check(psame, "particles bitwise equal after restart");
+    }
+    amrex::Finalize();
+}
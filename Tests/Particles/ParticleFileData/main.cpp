@@ -0,0 +1,182 @@
+//
+// Writes a particle checkpoint in both the row and the columnar layout,
+// restarts from each, and compares every component ParticleFileData
+// reads from the files against the particles in memory.  Aborts on any
+// difference.
+//
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleFileData.H>
+
+using namespace amrex;
+
+static constexpr int NSR = 1;
+static constexpr int NSI = 1;
+static constexpr int NAR = 2;
+static constexpr int NAI = 1;
+
+typedef ParticleContainer<NSR, NSI, NAR, NAI> PC;
+typedef ParIter<NSR, NSI, NAR, NAI> PIter;
+
+namespace {
+
+void setValues (PC& pc)
+{
+    for (PIter pti(pc, 0); pti.isValid(); ++pti)
+    {
+        auto& aos = pti.GetArrayOfStructs();
+        auto& soa = pti.GetStructOfArrays();
+        for (int i = 0, N = aos.size(); i < N; ++i)
+        {
+            auto& p = aos[i];
+            const int id = p.id();
+            p.rdata(0) = id*0.5;
+            p.idata(0) = id*3;
+            soa.GetRealData(0)[i] = id+0.25;
+            soa.GetRealData(1)[i] = id*2.0;
+            soa.GetIntData(0)[i] = id-7;
+        }
+    }
+}
+
+//
+// The file components are the positions, then the struct and then the
+// array components, in order.
+//
+ParticleReal realComp (const PIter& pti, int i, int comp)
+{
+    const auto& p = pti.GetArrayOfStructs()[i];
+    if (comp < AMREX_SPACEDIM) return p.pos(comp);
+    comp -= AMREX_SPACEDIM;
+    if (comp < NSR) return p.rdata(comp);
+    return pti.GetStructOfArrays().GetRealData(comp-NSR)[i];
+}
+
+int intComp (const PIter& pti, int i, int comp)
+{
+    const auto& p = pti.GetArrayOfStructs()[i];
+    if (comp == 0) return p.id();
+    if (comp == 1) return p.cpu();
+    comp -= 2;
+    if (comp < NSI) return p.idata(comp);
+    return pti.GetStructOfArrays().GetIntData(comp-NSI)[i];
+}
+
+long compare (PC& pc, const std::string& dir, const std::string& name)
+{
+    ParticleFileData pfd(dir, name);
+
+    long nbad = 0;
+    if (pfd.numParticles() != pc.TotalNumberOfParticles()) ++nbad;
+
+    const int nreal = pfd.realCompNames().size();
+    const int nint  = pfd.intCompNames().size();
+    if (nreal != AMREX_SPACEDIM + NSR + NAR || nint != 2 + NSI + NAI) {
+        amrex::Abort("ParticleFileData test: unexpected number of components in " + name);
+    }
+
+    for (PIter pti(pc, 0); pti.isValid(); ++pti)
+    {
+        const int grid = pti.index();
+        const int np = pti.numParticles();
+        if (pfd.numParticles(0, grid) != np) {
+            ++nbad;
+            continue;
+        }
+        for (int comp = 0; comp < nreal; ++comp) {
+            const auto r = pfd.getReal(pfd.realCompNames()[comp], 0, grid);
+            for (int i = 0; i < np; ++i) {
+                if (r[i] != realComp(pti, i, comp)) ++nbad;
+            }
+        }
+        for (int comp = 0; comp < nint; ++comp) {
+            const auto r = pfd.getInt(pfd.intCompNames()[comp], 0, grid);
+            for (int i = 0; i < np; ++i) {
+                if (r[i] != intComp(pti, i, comp)) ++nbad;
+            }
+        }
+    }
+
+    ParallelDescriptor::ReduceLongSum(nbad);
+    return nbad;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 8;
+        int num_particles = 5000;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("num_particles", num_particles);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        const Geometry geom(domain, &rb, 0);
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        const DistributionMapping dm(ba);
+
+        PC pc(geom, dm, ba);
+        PC::ParticleInitData pdata = {{0.}, {0}, {0., 0.}, {0}};
+        pc.InitRandom(num_particles, 17, pdata);
+        setValues(pc);
+
+        const std::string dir("ParticleFileData_chk");
+        pc.SetUseColumnar(false);
+        pc.Checkpoint(dir, "row");
+        pc.SetUseColumnar(true);
+        pc.Checkpoint(dir, "col");
+        ParallelDescriptor::Barrier();
+
+        long nbad = 0;
+        for (const std::string name : {"row", "col"})
+        {
+            PC restarted(geom, dm, ba);
+            restarted.Restart(dir, name);
+            const long n = compare(restarted, dir, name);
+            amrex::Print() << name << ": " << restarted.TotalNumberOfParticles()
+                           << " particles, " << n << " wrong values\n";
+            nbad += n;
+        }
+
+        //
+        // Several grids at once, in an order that is not the file order,
+        // read the same from both layouts.
+        //
+        ParticleFileData row(dir, "row"), col(dir, "col");
+        if (!col.columnar() || row.columnar()) ++nbad;
+        Vector<int> grids;
+        for (int i = row.numGrids(0)-1; i >= 0; i -= 3) grids.push_back(i);
+        for (const auto& comp : row.realCompNames()) {
+            if (row.getReal(comp, 0, grids) != col.getReal(comp, 0, grids)) ++nbad;
+            if (row.getReal(comp, 0) != col.getReal(comp, 0)) ++nbad;
+        }
+        for (const auto& comp : row.intCompNames()) {
+            if (row.getInt(comp, 0, grids) != col.getInt(comp, 0, grids)) ++nbad;
+        }
+        const auto x = col.getReal("x", 0, grids);
+        long offset = 0;
+        for (int grid : grids) {
+            if (col.getReal("x", 0, grid) != Vector<ParticleReal>(x.begin()+offset,
+                                                                    x.begin()+offset+col.numParticles(0,grid))) {
+                ++nbad;
+            }
+            offset += col.numParticles(0, grid);
+        }
+
+        if (nbad != 0) {
+            amrex::Abort("ParticleFileData test failed");
+        }
+        amrex::Print() << "ParticleFileData reads the particles in memory\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,139 @@
+//
+// Writes a two-level plotfile without and with plotfile.pyramid_levels,
+// and checks what PlotFileData reads from them.  With the pyramid,
+// hasCoarsened must hold for ratios 2, 4, ..., 2^pyramid_levels and
+// getCoarsened must be bitwise equal to averaging down by 2 that many
+// times.  Without it, getCoarsened must be bitwise equal to a single
+// average_down.  The min and max must match the data either way.
+// Aborts on any failure.
+//
+#include <cmath>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("PlotfilePyramid: " + what);
+}
+
+//! Whether c, on any BoxArray, is bitwise equal to ref.
+bool same (const MultiFab& c, const MultiFab& ref)
+{
+    if (c.boxArray() != ref.boxArray().boxList().data()) return false;
+    MultiFab cc(ref.boxArray(), ref.DistributionMap(), 1, 0);
+    cc.ParallelCopy(c);
+    long ndiff = 0;
+    for (MFIter mfi(ref); mfi.isValid(); ++mfi) {
+        auto const& x = cc.const_array(mfi);
+        auto const& y = ref.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+        {
+            if (x(i,j,k) != y(i,j,k)) ++ndiff;
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff == 0;
+}
+
+//! Component comp of mf averaged down by 2, nhalve times.
+MultiFab halved (const MultiFab& mf, int comp, int nhalve)
+{
+    MultiFab r(mf.boxArray(), mf.DistributionMap(), 1, 0);
+    MultiFab::Copy(r, mf, comp, 0, 1, 0);
+    for (int n = 0; n < nhalve; ++n) {
+        MultiFab c(amrex::coarsen(r.boxArray(),2), r.DistributionMap(), 1, 0);
+        amrex::average_down(r, c, 0, 1, 2);
+        r = std::move(c);
+    }
+    return r;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int pyramid_levels = 3;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("pyramid_levels", pyramid_levels);
+        }
+
+        const int nlevels = 2;
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        const RealBox rb(AMREX_D_DECL(0.,0.,0.), AMREX_D_DECL(1.,1.,1.));
+        Vector<Geometry> geom{Geometry(domain, &rb, 0), Geometry(amrex::refine(domain,2), &rb, 0)};
+
+        Vector<BoxArray> ba{BoxArray(domain), BoxArray(Box(IntVect(n_cell/2), IntVect(3*n_cell/2-1)))};
+        Vector<MultiFab> mf(nlevels);
+        for (int lev = 0; lev < nlevels; ++lev) {
+            ba[lev].maxSize(max_grid_size);
+            mf[lev].define(ba[lev], DistributionMapping(ba[lev]), 2, 0);
+            const Real dx = 1.0/(n_cell*(lev+1));
+            for (MFIter mfi(mf[lev]); mfi.isValid(); ++mfi) {
+                auto const& a = mf[lev].array(mfi);
+                amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+                {
+                    const Real x = (i+0.5)*dx, y = (j+0.5)*dx, z = (k+0.5)*dx;
+                    a(i,j,k,0) = std::sin(6*x)*std::cos(5*y) + z*z;
+                    a(i,j,k,1) = std::exp(-20*((x-0.5)*(x-0.5)+(y-0.5)*(y-0.5)+(z-0.5)*(z-0.5)));
+                });
+            }
+        }
+        const Vector<std::string> varnames{"density", "blob"};
+
+        for (int npyr : {0, pyramid_levels})
+        {
+            ParmParse pp("plotfile");
+            pp.add("pyramid_levels", npyr);
+
+            const std::string name = "plt_pyramid_" + std::to_string(npyr);
+            WriteMultiLevelPlotfile(name, nlevels, GetVecOfConstPtrs(mf), varnames, geom,
+                                    0.0, Vector<int>(nlevels,0), Vector<IntVect>(nlevels-1,IntVect(2)));
+            ParallelDescriptor::Barrier();
+
+            PlotFileData pf(name);
+            for (int lev = 0; lev < nlevels; ++lev) {
+                const std::string tag = "pyramid_levels " + std::to_string(npyr)
+                    + " level " + std::to_string(lev);
+                for (int n = 0; n < 2; ++n) {
+                    check(pf.min(lev,varnames[n]) == mf[lev].min(n) &&
+                          pf.max(lev,varnames[n]) == mf[lev].max(n),
+                          tag + " " + varnames[n] + " min and max");
+                }
+                for (int nhalve = 1, ratio = 2; ba[lev].coarsenable(ratio); ++nhalve, ratio *= 2) {
+                    const std::string what = tag + " ratio " + std::to_string(ratio);
+                    const bool has = nhalve <= npyr;
+                    check(pf.hasCoarsened(lev,ratio) == has, what + " hasCoarsened");
+                    MultiFab c = pf.getCoarsened(lev, "blob", ratio);
+                    if (has) {
+                        check(same(c, halved(mf[lev],1,nhalve)), what + " getCoarsened from the pyramid");
+                    } else {
+                        MultiFab ref(amrex::coarsen(ba[lev],ratio), mf[lev].DistributionMap(), 1, 0);
+                        MultiFab fine(ba[lev], mf[lev].DistributionMap(), 1, 0);
+                        MultiFab::Copy(fine, mf[lev], 1, 0, 1, 0);
+                        amrex::average_down(fine, ref, 0, 1, ratio);
+                        check(same(c, ref), what + " getCoarsened from the full data");
+                    }
+                }
+            }
+        }
+    }
+    amrex::Finalize();
+}
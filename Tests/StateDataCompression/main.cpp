@@ -0,0 +1,140 @@
+//
+// Compresses the old data of a StateData and checks that reads decode
+// them bitwise exactly, once, and keep the compressed copy; that
+// swapTimeLevels drops the compressed copy without decoding it; that
+// reset makes the decoded old data the new data; and that lossy
+// compression stays within its error bound.  Aborts on any failure.
+//
+#include <cmath>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_StateData.H>
+#include <AMReX_StateDescriptor.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("StateDataCompression: " + what);
+}
+
+void fill (MultiFab& mf, Real shift)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), mf.nComp(), [&] (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = std::exp(-0.001*(i*i + j*j + k*k)) + n + shift;
+        });
+    }
+}
+
+//! Largest difference between a and b on their valid cells.
+Real maxDiff (const MultiFab& a, const MultiFab& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), 0);
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), 0);
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), 0);
+    Real m = 0.0;
+    for (int n = 0; n < a.nComp(); ++n) m = std::max(m, d.norm0(n));
+    return m;
+}
+
+//! Whether all processes report ok.
+bool all (bool ok)
+{
+    ParallelDescriptor::ReduceBoolAnd(ok);
+    return ok;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        Real tolerance = 1.e-4;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("tolerance", tolerance);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const int ncomp = 2;
+        StateDescriptor desc(IndexType::TheCellType(), StateDescriptor::Point, 0, 0, ncomp,
+                             &cell_cons_interp);
+        const Real time = 1.0, dt = 0.5, old_time = time - dt;
+
+        StateData sd(domain, ba, dm, &desc, time, dt, FArrayBoxFactory());
+        sd.allocOldData();
+        fill(sd.oldData(), 0.0);
+        fill(sd.newData(), 10.0);
+        MultiFab old_ref(ba, dm, ncomp, 0), new_ref(ba, dm, ncomp, 0);
+        MultiFab::Copy(old_ref, sd.oldData(), 0, 0, ncomp, 0);
+        MultiFab::Copy(new_ref, sd.newData(), 0, 0, ncomp, 0);
+
+        sd.compressOldData(0.0);
+        auto const& cs = sd.compressionStats();
+        check(all(sd.oldDataIsCompressed() && cs.packed_bytes < cs.raw_bytes
+                  && cs.nencodes > 0 && cs.ndecodes == 0),
+              "old data compressed");
+
+        Vector<MultiFab*> data;
+        Vector<Real> datatime;
+        sd.getData(data, datatime, old_time);
+        check(data.size() == 1 && maxDiff(*data[0], old_ref) == 0.0,
+              "lossless old data read back exactly");
+        const long ndecodes = cs.ndecodes;
+        sd.getData(data, datatime, old_time);
+        const MultiFab& cold = static_cast<const StateData&>(sd).oldData();
+        check(all(sd.oldDataIsCompressed() && cs.ndecodes == ndecodes && &cold == data[0]),
+              "reads keep the compressed copy and decode once");
+
+        sd.releaseDecodedOldData();
+        sd.getData(data, datatime, old_time);
+        check(all(cs.ndecodes > ndecodes) && maxDiff(*data[0], old_ref) == 0.0,
+              "released data decoded again");
+
+        sd.releaseDecodedOldData();
+        const long nd = cs.ndecodes;
+        sd.swapTimeLevels(dt);
+        check(all(!sd.oldDataIsCompressed() && sd.hasOldData() && cs.ndecodes == nd)
+              && maxDiff(sd.oldData(), new_ref) == 0.0,
+              "swapTimeLevels drops the compressed copy without decoding");
+
+        sd.compressOldData(0.0);
+        sd.releaseDecodedOldData();
+        sd.reset();
+        check(all(!sd.oldDataIsCompressed()) && maxDiff(sd.newData(), new_ref) == 0.0,
+              "reset makes the decoded old data new");
+
+        sd.allocOldData();
+        fill(sd.oldData(), 0.0);
+        sd.compressOldData(tolerance);
+        const Real err = maxDiff(sd.oldData(), old_ref);
+        check(err <= tolerance && err > 0.0 && all(cs.packed_bytes < cs.raw_bytes),
+              "lossy old data within the tolerance");
+
+        sd.compressOldData(0.0);
+        const MultiFab& mold = sd.oldData();
+        check(all(!sd.oldDataIsCompressed()) && maxDiff(mold, old_ref) == err,
+              "non-const access discards the compressed copy");
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,168 @@
+//
+// Checks TArena: size-class rounding, reuse of freed blocks from the
+// thread cache, spilling to the global pool and reuse by another thread,
+// unpooled large requests, release(), and a multi-threaded random
+// allocation pattern that verifies the contents of every block.  Then
+// checks that amrex.use_thread_caching_arena makes The_Arena a TArena.
+// Aborts on any failure.
+//
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_TArena.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("TArena: " + what);
+}
+
+void sizeClasses ()
+{
+    TArena a;
+    bool ok = true;
+    for (std::size_t n : {1, 7, 16, 17, 100, 1000, 4097, 65537, 1000000}) {
+        void* p = a.alloc(n);
+        const TArena::Stats s = a.stats();
+        // Blocks are aligned to Arena::align_size, which is 16.
+        ok = ok && reinterpret_cast<std::uintptr_t>(p) % 16 == 0
+                && s.bytes_in_use == n
+                && s.class_bytes_in_use >= n
+                && 4*s.class_bytes_in_use <= 5*Arena::align(std::max(n, std::size_t(16)));
+        a.free(p);
+    }
+    check(ok, "size classes waste at most 25%");
+}
+
+void threadCache ()
+{
+    TArena a;
+    void* p = a.alloc(5000);
+    a.free(p);
+    void* q = a.alloc(4900);   // same size class
+    const TArena::Stats s = a.stats();
+    check(p == q && s.num_thread_hits == 1 && s.num_system_alloc == 1,
+          "freed block reused from the thread cache");
+    a.free(q);
+}
+
+void pool ()
+{
+    // Room for about two blocks in a thread's cache.
+    const std::size_t n = 64*1024;
+    TArena a(1024*1024, 2*n);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; ++i) blocks.push_back(a.alloc(n));
+    for (void* p : blocks) a.free(p);
+
+    std::thread t([&] () {
+        for (int i = 0; i < 2; ++i) a.free(a.alloc(n));
+    });
+    t.join();
+    const TArena::Stats s = a.stats();
+    check(s.num_pool_hits > 0 && s.num_system_alloc == 8,
+          "spilled blocks reused by another thread");
+}
+
+void unpooled ()
+{
+    TArena a(1024*1024);
+    void* p = a.alloc(4*1024*1024);
+    const std::size_t used = a.heap_space_used();
+    a.free(p);
+    check(used >= std::size_t(4*1024*1024) && a.heap_space_used() == 0,
+          "large requests go to the system");
+}
+
+void stress (int nthreads)
+{
+    TArena a(1 << 20, 1 << 22);
+    std::vector<int> bad(nthreads, 0);
+    auto work = [&] (int tid)
+    {
+        std::mt19937 g(tid);
+        std::vector<std::pair<unsigned char*,std::size_t> > live;
+        auto release = [&] (std::size_t k)
+        {
+            unsigned char* p = live[k].first;
+            const std::size_t nb = live[k].second;
+            for (std::size_t i = 0; i < nb; i += 61) {
+                if (p[i] != static_cast<unsigned char>(tid + i)) ++bad[tid];
+            }
+            a.free(p);
+            live.erase(live.begin() + k);
+        };
+        for (int it = 0; it < 20000; ++it) {
+            if (live.size() < 50 && g() % 2) {
+                const std::size_t nb = g() % (1 << 21);
+                auto p = static_cast<unsigned char*>(a.alloc(nb));
+                for (std::size_t i = 0; i < nb; i += 61) {
+                    p[i] = static_cast<unsigned char>(tid + i);
+                }
+                live.emplace_back(p, nb);
+            } else if (!live.empty()) {
+                release(g() % live.size());
+            }
+        }
+        while (!live.empty()) release(live.size()-1);
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nthreads; ++i) threads.emplace_back(work, i);
+    for (auto& t : threads) t.join();
+
+    int nbad = 0;
+    for (int b : bad) nbad += b;
+    check(nbad == 0, "blocks keep their contents across threads");
+
+    TArena::Stats s = a.stats();
+    check(s.bytes_in_use == 0 && s.class_bytes_in_use == 0 && s.bytes_cached > 0,
+          "everything freed is cached");
+    check(s.num_thread_hits + s.num_pool_hits + s.num_system_alloc == s.num_alloc,
+          "every allocation counted once");
+
+    a.release();
+    s = a.stats();
+    check(s.heap_space_used == 0 && s.bytes_cached == 0, "release returns all memory");
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int nthreads = 4;
+        {
+            ParmParse pp;
+            pp.query("nthreads", nthreads);
+        }
+
+        sizeClasses();
+        threadCache();
+        pool();
+        unpooled();
+        stress(nthreads);
+
+        check(dynamic_cast<TArena*>(The_Arena()) != nullptr, "The_Arena is a TArena");
+        const Box domain(IntVect(0), IntVect(31));
+        BoxArray ba(domain);
+        ba.maxSize(16);
+        MultiFab mf(ba, DistributionMapping(ba), 2, 1);
+        mf.setVal(1.0);
+        check(mf.sum(1) == domain.d_numPts(), "MultiFab in The_Arena");
+    }
+    amrex::Finalize();
+}
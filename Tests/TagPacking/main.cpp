@@ -0,0 +1,99 @@
+//
+// Builds the grids of an AmrMesh from the same tags with amr.pack_tags
+// on and off, and aborts if the BoxArrays differ.  The tagged sphere
+// crosses a periodic boundary, and ManualTagsPlacement clears part of it.
+//
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_AmrMesh.H>
+#include <AMReX_TagBox.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+class TagMesh
+    : public AmrMesh
+{
+public:
+
+    explicit TagMesh (bool pack)
+    {
+        pack_tags = pack;
+
+        ParmParse pp;
+        pp.getarr("center", m_center);
+        pp.get("radius", m_radius);
+    }
+
+    virtual void ErrorEst (int lev, TagBoxArray& tags, Real time, int ngrow) override
+    {
+        const Real* dx = Geom(lev).CellSize();
+        const Real* problo = Geom(lev).ProbLo();
+        const Real* probhi = Geom(lev).ProbHi();
+        const Real r = m_radius / (lev+1);
+
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi)
+        {
+            TagBox& fab = tags[mfi];
+            const Box& bx = mfi.validbox();
+            for (BoxIterator bi(bx); bi.ok(); ++bi)
+            {
+                const IntVect& iv = bi();
+                Real d2 = 0.0;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    Real d = problo[idim] + (iv[idim]+0.5)*dx[idim] - m_center[idim];
+                    if (Geom(lev).isPeriodic(idim)) {
+                        const Real len = probhi[idim] - problo[idim];
+                        d = std::min(std::abs(d), len - std::abs(d));
+                    }
+                    d2 += d*d;
+                }
+                if (d2 < r*r) fab(iv) = TagBox::SET;
+            }
+        }
+    }
+
+    virtual void ManualTagsPlacement (int lev, TagBoxArray& tags, const Vector<IntVect>& bf_lev) override
+    {
+        AMREX_ALWAYS_ASSERT(!tags.isPacked());
+        // Clear the coarsened tags in the low z corner.
+        Box bx = amrex::coarsen(Geom(lev).Domain(), bf_lev[lev]);
+        bx.setBig(2, bx.smallEnd(2) + bx.length(2)/4);
+        tags.setVal(BoxArray(bx), TagBox::CLEAR);
+    }
+
+private:
+
+    Vector<Real> m_center;
+    Real m_radius;
+};
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        TagMesh packed(true);
+        TagMesh unpacked(false);
+
+        packed.MakeNewGrids();
+        unpacked.MakeNewGrids();
+
+        if (packed.finestLevel() != unpacked.finestLevel()) {
+            amrex::Abort("TagPacking: finest levels differ");
+        }
+
+        for (int lev = 0; lev <= packed.finestLevel(); ++lev)
+        {
+            const BoxArray& ba = packed.boxArray(lev);
+            if (ba != unpacked.boxArray(lev)) {
+                amrex::Print() << "packed:\n" << ba << "\nunpacked:\n" << unpacked.boxArray(lev) << "\n";
+                amrex::Abort("TagPacking: grids differ at level " + std::to_string(lev));
+            }
+            amrex::Print() << "level " << lev << ": " << ba.size() << " grids, "
+                           << ba.numPts() << " cells\n";
+        }
+
+        amrex::Print() << "pack_tags gives the same grids\n";
+    }
+    amrex::Finalize();
+}
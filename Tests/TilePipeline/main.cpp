@@ -0,0 +1,149 @@
+//
+// Runs a smoothing, flux and update sequence as a TilePipeline and as
+// separate MFIter passes over MultiFabs, and aborts if the results differ.
+// The smoothing runs on a grown box because the fluxes need its ghost
+// cells, and the pipeline declares the MultiFabs each stage accesses.
+//
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_TilePipeline.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void smooth (Box const& bx, Array4<Real const> const& s, Array4<Real> const& sm)
+{
+    amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+    {
+        sm(i,j,k) = (6.0*s(i,j,k) + s(i-1,j,k) + s(i+1,j,k)
+                                  + s(i,j-1,k) + s(i,j+1,k)
+                                  + s(i,j,k-1) + s(i,j,k+1)) / 12.0;
+    });
+}
+
+void flux (Box const& bx, int dir, Array4<Real const> const& sm, Array4<Real> const& f)
+{
+    const IntVect e = IntVect::TheDimensionVector(dir);
+    amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+    {
+        f(i,j,k) = sm(i,j,k) - sm(i-e[0],j-e[1],k-e[2]);
+    });
+}
+
+void update (Box const& bx, Real dt, Array4<Real const> const& s,
+             Array4<Real const> const& fx, Array4<Real const> const& fy,
+             Array4<Real const> const& fz, Array4<Real> const& snew)
+{
+    amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+    {
+        snew(i,j,k) = s(i,j,k) + dt*(fx(i+1,j,k) - fx(i,j,k)
+                                   + fy(i,j+1,k) - fy(i,j,k)
+                                   + fz(i,j,k+1) - fz(i,j,k));
+    });
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        const Real dt = 0.1;
+
+        MultiFab S(ba, dm, 1, 2);
+        for (MFIter mfi(S); mfi.isValid(); ++mfi)
+        {
+            auto const& s = S.array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [=] (int i, int j, int k) noexcept
+            {
+                s(i,j,k) = std::sin(0.3*i) * std::cos(0.2*j) + 0.01*k*k;
+            });
+        }
+        S.FillBoundary(Periodicity(domain.size()));
+
+        //
+        // Separate passes.
+        //
+        MultiFab Sref(ba, dm, 1, 0);
+        {
+            MultiFab sm(ba, dm, 1, 1);
+            Array<MultiFab,AMREX_SPACEDIM> f;
+            for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                f[dir].define(amrex::convert(ba, IntVect::TheDimensionVector(dir)), dm, 1, 0);
+            }
+
+            for (MFIter mfi(sm, true); mfi.isValid(); ++mfi) {
+                smooth(mfi.growntilebox(), S.const_array(mfi), sm.array(mfi));
+            }
+            for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                for (MFIter mfi(f[dir], true); mfi.isValid(); ++mfi) {
+                    flux(mfi.tilebox(), dir, sm.const_array(mfi), f[dir].array(mfi));
+                }
+            }
+            for (MFIter mfi(Sref, true); mfi.isValid(); ++mfi) {
+                update(mfi.tilebox(), dt, S.const_array(mfi), f[0].const_array(mfi),
+                       f[1].const_array(mfi), f[2].const_array(mfi), Sref.array(mfi));
+            }
+        }
+
+        //
+        // The same passes fused tile by tile.
+        //
+        MultiFab Snew(ba, dm, 1, 0);
+        {
+            TilePipeline pipe;
+            const int sm = pipe.addTemp(1);
+            int f[AMREX_SPACEDIM];
+            for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                f[dir] = pipe.addTemp(1, IndexType(IntVect::TheDimensionVector(dir)));
+            }
+
+            pipe.addStage("smooth", {sm}, {}, {}, {{&S,IntVect(1)}},
+                          [&] (Box const& bx, TilePipeline::Tile const& t)
+            {
+                smooth(bx, S.const_array(t.mfi()), t.array(sm));
+            });
+            pipe.addStage("flux", {f[0],f[1],f[2]}, {{sm,IntVect(1)}},
+                          [&] (Box const& bx, TilePipeline::Tile const& t)
+            {
+                for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                    flux(amrex::surroundingNodes(bx,dir), dir, t.array(sm), t.array(f[dir]));
+                }
+            });
+            pipe.addStage("update", {}, {{f[0],IntVect(0)}, {f[1],IntVect(0)}, {f[2],IntVect(0)}},
+                          {&Snew}, {{&S,IntVect(0)}},
+                          [&] (Box const& bx, TilePipeline::Tile const& t)
+            {
+                update(bx, dt, S.const_array(t.mfi()), t.array(f[0]), t.array(f[1]),
+                       t.array(f[2]), Snew.array(t.mfi()));
+            });
+
+            AMREX_ALWAYS_ASSERT(pipe.nGrowStage(0) == IntVect(1));
+
+            pipe.run(Snew);
+        }
+
+        MultiFab::Subtract(Snew, Sref, 0, 0, 1, 0);
+        const Real diff = Snew.norm0();
+        amrex::Print() << "max difference: " << diff << "\n";
+        if (diff != 0.0) {
+            amrex::Abort("TilePipeline: fused and separate passes differ");
+        }
+    }
+    amrex::Finalize();
+}
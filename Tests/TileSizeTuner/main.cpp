@@ -0,0 +1,128 @@
+//
+// Tunes the tile size of MultiFab::LinComb, and of a region whose
+// FabArray has cells on one process only, and checks that every process
+// locks in the same candidate once all have been tried, and that LinComb
+// still computes the right values.  Run on several processes.  Aborts on
+// any failure.
+//
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_TileSizeTuner.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("TileSizeTuner: " + what);
+}
+
+//! The tile size the next invocation of the region uses, if it is the same on all processes.
+bool sameEverywhere (const std::string& name, const FabArrayBase& fa, IntVect& ts)
+{
+    {
+        TileSizeTuner tuner(name, fa);
+        ts = tuner.tileSize();
+    }
+    int v[2*AMREX_SPACEDIM];
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        v[d] = ts[d];
+        v[AMREX_SPACEDIM+d] = -ts[d];
+    }
+    ParallelDescriptor::ReduceIntMax(v, 2*AMREX_SPACEDIM);
+    bool same = true;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        same = same && v[d] == -v[AMREX_SPACEDIM+d];
+    }
+    return same;
+}
+
+bool isCandidate (const IntVect& ts)
+{
+    ParmParse pp("tiletuner");
+    Vector<int> cand;
+    pp.getarr("candidates", cand);
+    if (ts == FabArrayBase::mfiter_tile_size) return true;
+    for (int i = 0; i+AMREX_SPACEDIM <= static_cast<int>(cand.size()); i += AMREX_SPACEDIM) {
+        if (ts == IntVect(AMREX_D_DECL(cand[i],cand[i+1],cand[i+2]))) return true;
+    }
+    return false;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int niter = 20;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("niter", niter);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        //
+        // LinComb is tuned on every call.
+        //
+        MultiFab x(ba, dm, 2, 1), y(ba, dm, 2, 1), dst(ba, dm, 2, 1);
+        x.setVal(1.0);
+        y.setVal(2.0);
+        for (int it = 0; it < niter; ++it) {
+            dst.setVal(0.0);
+            MultiFab::LinComb(dst, 3.0, x, 0, 0.5, y, 0, 0, 2, 1);
+        }
+        check(dst.min(0,1) == 4.0 && dst.max(1,1) == 4.0, "MultiFab::LinComb values");
+
+        IntVect ts, ts2;
+        check(sameEverywhere("MultiFab::LinComb", dst, ts), "MultiFab::LinComb same tile size");
+        check(isCandidate(ts), "MultiFab::LinComb chose a candidate");
+        sameEverywhere("MultiFab::LinComb", dst, ts2);
+        check(ts == ts2, "MultiFab::LinComb tile size locked in");
+        amrex::Print() << "MultiFab::LinComb tile size " << ts << "\n";
+
+        //
+        // A region with cells on the I/O process only, decided explicitly.
+        //
+        BoxArray ba1(Box(IntVect(0), IntVect(max_grid_size-1)));
+        Vector<int> pmap(1, ParallelDescriptor::IOProcessorNumber());
+        DistributionMapping dm1(pmap);
+        MultiFab z(ba1, dm1, 1, 0);
+        z.setVal(0.0);
+
+        int ntrials = 0;
+        Vector<int> cand;
+        {
+            ParmParse pp("tiletuner");
+            pp.get("ntrials", ntrials);
+            pp.getarr("candidates", cand);
+        }
+        // The candidates of the inputs file and the default tile size.
+        const int ninvoc = ntrials * (static_cast<int>(cand.size())/AMREX_SPACEDIM + 1);
+        for (int it = 0; it < ninvoc; ++it) {
+            TileSizeTuner tuner("test::one_process", z);
+            for (MFIter mfi(z, tuner.info()); mfi.isValid(); ++mfi) {
+                z[mfi].plus(1.0, mfi.tilebox());
+            }
+        }
+        check(z.min(0) == ninvoc && z.max(0) == ninvoc, "one process region values");
+
+        TileSizeTuner::Decide();
+        check(sameEverywhere("test::one_process", z, ts), "one process region same tile size");
+        check(isCandidate(ts), "one process region chose a candidate");
+        amrex::Print() << "test::one_process tile size " << ts << "\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,179 @@
+//
+// Writes a MultiFab with text headers in header versions 1 through 5 and
+// the NATIVE and NATIVE_32 formats, converts each header to binary with
+// VisMF::ConvertHeader and back, and also writes with
+// vismf.binaryheader = 1.  Reads through the binary headers must give
+// the same data, BoxArray and min and max as through the text ones, and
+// converting back to text must give the original header byte for byte.
+// Aborts on any failure.
+//
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_VisMF.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("VisMFBinaryHeader: " + what);
+}
+
+//! The contents of a file, read on the I/O process and broadcast.
+std::string fileContents (const std::string& name)
+{
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(name, buf);
+    return std::string(buf.begin(), buf.end());
+}
+
+bool isBinary (const std::string& header)
+{
+    return header.compare(0, 20, "VisMF binary header\n") == 0;
+}
+
+//! Whether a, read back from disk, is bitwise equal to mf including ghost cells.
+bool sameData (const MultiFab& a, const MultiFab& mf)
+{
+    long ndiff = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& x = a.const_array(mfi);
+        auto const& y = mf.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), mf.nComp(), [&] (int i, int j, int k, int n)
+        {
+            if (x(i,j,k,n) != y(i,j,k,n)) ++ndiff;
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff == 0;
+}
+
+//! Whether two VisMFs of the same data describe it the same way.
+bool sameHeader (const VisMF& a, const VisMF& b, bool fabminmax)
+{
+    bool ok = a.size() == b.size() && a.nComp() == b.nComp()
+        && a.nGrowVect() == b.nGrowVect() && a.boxArray() == b.boxArray()
+        && a.hasMinMax() == b.hasMinMax();
+    for (int n = 0; ok && n < a.nComp(); ++n) {
+        if (a.hasMinMax()) {
+            ok = a.min(n) == b.min(n) && a.max(n) == b.max(n);
+        }
+        for (int i = 0; ok && fabminmax && i < a.size(); ++i) {
+            ok = a.min(i,n) == b.min(i,n) && a.max(i,n) == b.max(i,n);
+        }
+    }
+    return ok;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 8;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const int ncomp = 3;
+        const int ng = 1;
+        MultiFab mf(ba, dm, ncomp, ng);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            auto const& a = mf.array(mfi);
+            amrex::LoopOnCpu(mfi.fabbox(), ncomp, [&] (int i, int j, int k, int n)
+            {
+                a(i,j,k,n) = std::sin(0.1*i + 0.2*j*(n+1)) + 0.01*k*n;
+            });
+        }
+
+        for (int vers = VisMF::Header::Version_v1; vers <= VisMF::Header::Compressed_v1; ++vers)
+        {
+            for (auto fmt : {FABio::FAB_NATIVE, FABio::FAB_NATIVE_32})
+            {
+                VisMF::SetHeaderVersion(static_cast<VisMF::Header::Version>(vers));
+                FArrayBox::setFormat(fmt);
+                const bool single = fmt == FABio::FAB_NATIVE_32 && vers != VisMF::Header::Compressed_v1;
+                const bool fabminmax = vers == VisMF::Header::Version_v1
+                                    || vers == VisMF::Header::NoFabHeaderMinMax_v1;
+                const std::string tag = "version " + std::to_string(vers)
+                                      + (single ? " NATIVE_32" : " NATIVE");
+                const std::string name = "vismf_bh_" + std::to_string(vers) + "_" + std::to_string(fmt);
+
+                VisMF::SetBinaryHeader(false);
+                VisMF::Write(mf, name);
+                ParallelDescriptor::Barrier();
+                const std::string text = fileContents(name + "_H");
+                check(!isBinary(text), tag + " text header written");
+
+                MultiFab expected(ba, dm, ncomp, ng);
+                VisMF::Read(expected, name);
+                if (!single) {
+                    check(sameData(expected, mf), tag + " text header Read");
+                }
+
+                VisMF tvmf(name);
+
+                VisMF::ConvertHeader(name, true);
+                const std::string binary = fileContents(name + "_H");
+                check(isBinary(binary) && binary.size() < text.size(), tag + " ConvertHeader to binary");
+                check(VisMF::Check(name), tag + " binary header Check");
+                {
+                    MultiFab r(ba, dm, ncomp, ng);
+                    VisMF::Read(r, name);
+                    check(sameData(r, expected), tag + " binary header Read");
+
+                    VisMF bvmf(name);
+                    check(sameHeader(bvmf, tvmf, fabminmax), tag + " binary header contents");
+
+                    bool ok = true;
+                    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                        const FArrayBox& fab = bvmf.GetFab(mfi.index(), 1);
+                        auto const& a = expected.const_array(mfi);
+                        auto const& b = fab.const_array();
+                        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k)
+                        {
+                            if (a(i,j,k,1) != b(i,j,k)) ok = false;
+                        });
+                        bvmf.clear(mfi.index());
+                    }
+                    ParallelDescriptor::ReduceBoolAnd(ok);
+                    check(ok, tag + " binary header GetFab");
+                }
+
+                VisMF::ConvertHeader(name, false);
+                check(fileContents(name + "_H") == text, tag + " ConvertHeader back to text");
+
+                VisMF::SetBinaryHeader(true);
+                VisMF::Write(mf, name + "_b");
+                ParallelDescriptor::Barrier();
+                check(isBinary(fileContents(name + "_b_H")), tag + " binary header written");
+                {
+                    check(sameHeader(VisMF(name + "_b"), tvmf, fabminmax),
+                          tag + " written binary header contents");
+                    MultiFab r(ba, dm, ncomp, ng);
+                    VisMF::Read(r, name + "_b");
+                    check(sameData(r, expected), tag + " written binary header Read");
+                }
+            }
+        }
+        VisMF::SetBinaryHeader(false);
+    }
+    amrex::Finalize();
+}
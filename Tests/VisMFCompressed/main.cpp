@@ -0,0 +1,189 @@
+//
+// Writes a MultiFab with VisMF header version Compressed_v1 and checks
+// that Read, GetFab, WriteAsync, single precision reads and PlotFileData
+// give back the written data, ghost cells included, and that smooth data
+// take less space than with VersionOne.  A lossy tolerance must be
+// respected.  Aborts on any failure.
+//
+#include <cmath>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_fMultiFab.H>
+#include <AMReX_VisMF.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_Random.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("VisMFCompressed: " + what);
+}
+
+//! Component 0 is smooth, component 1 constant and component 2 random.
+void fill (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), mf.nComp(), [&] (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = (n == 0) ? std::sin(0.1*i)*std::cos(0.07*j) + 0.01*k
+                       : (n == 1) ? 1.0 : amrex::Random();
+        });
+    }
+}
+
+//! The largest difference between a and b on nghost ghost cells.
+Real maxDiff (const MultiFab& a, const MultiFab& b, int comp, int ncomp, int nghost)
+{
+    Real d = 0.0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& x = a.const_array(mfi);
+        auto const& y = b.const_array(mfi);
+        amrex::LoopOnCpu(amrex::grow(mfi.validbox(),nghost), ncomp, [&] (int i, int j, int k, int n)
+        {
+            d = std::max(d, std::abs(x(i,j,k,comp+n) - y(i,j,k,comp+n)));
+        });
+    }
+    ParallelDescriptor::ReduceRealMax(d);
+    return d;
+}
+
+long bytesWritten (const MultiFab& mf, const std::string& name)
+{
+    long nbytes = VisMF::Write(mf, name);
+    ParallelDescriptor::ReduceLongSum(nbytes);
+    return nbytes;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const int ncomp = 3;
+        const int ng = 1;
+        MultiFab mf(ba, dm, ncomp, ng);
+        fill(mf);
+
+        // The smooth and constant components alone, to compare sizes.
+        MultiFab smooth(ba, dm, 2, ng);
+        MultiFab::Copy(smooth, mf, 0, 0, 2, ng);
+
+        VisMF::SetHeaderVersion(VisMF::Header::Version_v1);
+        const long nbytes_v1 = bytesWritten(smooth, "vismf_smooth_v1");
+
+        VisMF::SetHeaderVersion(VisMF::Header::Compressed_v1);
+        const long nbytes_c = bytesWritten(smooth, "vismf_smooth_c");
+        amrex::Print() << "bytes with VersionOne " << nbytes_v1
+                       << ", with Compressed_v1 " << nbytes_c << "\n";
+        check(nbytes_c < nbytes_v1, "smaller than VersionOne");
+
+        bytesWritten(mf, "vismf_c");
+        {
+            MultiFab r(ba, dm, ncomp, ng);
+            VisMF::Read(r, "vismf_c");
+            check(maxDiff(r, mf, 0, ncomp, ng) == 0.0, "Read");
+
+            MultiFab d;
+            VisMF::Read(d, "vismf_c");
+            check(d.boxArray() == ba && d.nGrow() == ng, "Read into an undefined MultiFab");
+        }
+
+        {
+            VisMF vmf("vismf_c");
+            bool ok = true;
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                for (int n = 0; n < ncomp; ++n) {
+                    const FArrayBox& fab = vmf.GetFab(mfi.index(), n);
+                    auto const& a = mf.const_array(mfi);
+                    auto const& b = fab.const_array();
+                    ok = ok && fab.box() == mfi.fabbox();
+                    amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k)
+                    {
+                        if (a(i,j,k,n) != b(i,j,k)) ok = false;
+                    });
+                }
+                vmf.clear(mfi.index());
+            }
+            ParallelDescriptor::ReduceBoolAnd(ok);
+            check(ok, "GetFab");
+        }
+
+        {
+            auto status = VisMF::WriteAsync(mf, "vismf_c_async").get();
+            bool ok = status.ok;
+            ParallelDescriptor::ReduceBoolAnd(ok);
+            check(ok, "WriteAsync status");
+            ParallelDescriptor::Barrier();
+
+            MultiFab r(ba, dm, ncomp, ng);
+            VisMF::Read(r, "vismf_c_async");
+            check(maxDiff(r, mf, 0, ncomp, ng) == 0.0, "WriteAsync then Read");
+        }
+
+        {
+            fMultiFab f(ba, dm, ncomp, ng);
+            VisMF::Read(f, "vismf_c");
+            bool ok = true;
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                auto const& a = mf.const_array(mfi);
+                auto const& b = f.const_array(mfi);
+                amrex::LoopOnCpu(mfi.fabbox(), ncomp, [&] (int i, int j, int k, int n)
+                {
+                    if (static_cast<float>(a(i,j,k,n)) != b(i,j,k,n)) ok = false;
+                });
+            }
+            ParallelDescriptor::ReduceBoolAnd(ok);
+            check(ok, "single precision Read");
+        }
+
+        {
+            const Real tol = 1.e-4;
+            long nbytes = VisMF::Write(mf, "vismf_lossy", VisMF::NFiles, false, {tol, 0.0, tol});
+            ParallelDescriptor::ReduceLongSum(nbytes);
+            amrex::Print() << "bytes with tolerance " << tol << " " << nbytes << "\n";
+
+            MultiFab r(ba, dm, ncomp, ng);
+            VisMF::Read(r, "vismf_lossy");
+            check(maxDiff(r, mf, 0, 1, ng) <= tol, "lossy component 0 within tolerance");
+            check(maxDiff(r, mf, 1, 1, ng) == 0.0, "lossless component 1");
+            check(maxDiff(r, mf, 2, 1, ng) <= tol, "lossy component 2 within tolerance");
+        }
+
+        {
+            Geometry geom(domain, RealBox(AMREX_D_DECL(0.,0.,0.), AMREX_D_DECL(1.,1.,1.)),
+                          0, Array<int,AMREX_SPACEDIM>{AMREX_D_DECL(0,0,0)});
+            WriteSingleLevelPlotfile("plt_compressed", mf, {"a", "b", "c"}, geom, 0.0, 0);
+
+            PlotFileData pf("plt_compressed");
+            MultiFab c = pf.get(0, "c");
+            MultiFab r(ba, dm, 1, 0);
+            r.ParallelCopy(c);
+            MultiFab::Subtract(r, mf, 2, 0, 1, 0);
+            check(r.norm0() == 0.0, "PlotFileData get");
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,158 @@
+//
+// Writes MultiFabs and plotfiles in header versions 1, 3 and 5 and in
+// the NATIVE, NATIVE_32 and IEEE32 formats, and reads every FAB back on
+// every process with VisMF::GetFab and PlotFileData::getFab, once with
+// vismf.usemmap on and once with it off.  Both must give the written
+// values, rounded to float for the 32 bit formats.  Aborts on any
+// failure.
+//
+#include <cmath>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_VisMF.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+void check (bool ok, const std::string& what)
+{
+    amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+    if (!ok) amrex::Abort("VisMFMmap: " + what);
+}
+
+Real value (int i, int j, int k, int n)
+{
+    return std::sin(0.1*i + n) * std::cos(0.07*j) + 0.01*k + 1.e-9*n;
+}
+
+//! Whether fab holds value(.,.,.,n) on its box, rounded to float if single.
+bool matches (const FArrayBox& fab, int fcomp, int n, bool single)
+{
+    bool ok = true;
+    auto const& a = fab.const_array();
+    amrex::LoopOnCpu(fab.box(), [&] (int i, int j, int k)
+    {
+        Real v = value(i,j,k,n);
+        if (single) v = static_cast<float>(v);
+        if (a(i,j,k,fcomp) != v) ok = false;
+    });
+    return ok;
+}
+
+std::string formatName (FABio::Format fmt)
+{
+    return fmt == FABio::FAB_NATIVE ? "NATIVE"
+        : (fmt == FABio::FAB_NATIVE_32 ? "NATIVE_32" : "IEEE32");
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        // An odd number of components, so that not every FAB is aligned.
+        const int ncomp = 3;
+        const int ng = 1;
+        MultiFab mf(ba, dm, ncomp, ng);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            auto const& a = mf.array(mfi);
+            amrex::LoopOnCpu(mfi.fabbox(), ncomp, [&] (int i, int j, int k, int n)
+            {
+                a(i,j,k,n) = value(i,j,k,n);
+            });
+        }
+
+        const Geometry geom(domain, RealBox(AMREX_D_DECL(0.,0.,0.), AMREX_D_DECL(1.,1.,1.)),
+                            0, Array<int,AMREX_SPACEDIM>{AMREX_D_DECL(0,0,0)});
+        const Vector<std::string> varnames{"a", "b", "c"};
+
+        const bool usemmap = VisMF::GetUseMmap();
+
+        for (auto vers : {VisMF::Header::Version_v1,
+                          VisMF::Header::NoFabHeaderMinMax_v1,
+                          VisMF::Header::Compressed_v1})
+        {
+            for (auto fmt : {FABio::FAB_NATIVE, FABio::FAB_NATIVE_32, FABio::FAB_IEEE_32})
+            {
+                VisMF::SetHeaderVersion(vers);
+                FArrayBox::setFormat(fmt);
+
+                // Compressed data are always kept as native Reals.
+                const bool single = fmt != FABio::FAB_NATIVE && vers != VisMF::Header::Compressed_v1;
+                const std::string tag = "version " + std::to_string(vers) + " " + formatName(fmt);
+                const std::string name = "vismf_mmap_" + std::to_string(vers) + "_" + formatName(fmt);
+                const std::string plt = "plt_mmap_" + std::to_string(vers) + "_" + formatName(fmt);
+
+                VisMF::Write(mf, name);
+                WriteSingleLevelPlotfile(plt, mf, varnames, geom, 0.0, 0);
+                ParallelDescriptor::Barrier();
+
+                for (bool mmap : {true, false})
+                {
+                    VisMF::SetUseMmap(mmap);
+                    const std::string what = tag + (mmap ? " mmap" : " no mmap");
+
+                    bool ok = true;
+                    {
+                        VisMF vmf(name);
+                        for (int gid = 0; gid < ba.size(); ++gid) {
+                            for (int n = 0; n < ncomp; ++n) {
+                                const FArrayBox& fab = vmf.GetFab(gid, n);
+                                ok = ok && fab.box() == amrex::grow(ba[gid],ng)
+                                        && matches(fab, 0, n, single);
+                            }
+                            vmf.clear(gid);
+                        }
+                    }
+                    ParallelDescriptor::ReduceBoolAnd(ok);
+                    check(ok, what + " VisMF::GetFab");
+
+                    PlotFileData pf(plt);
+                    ok = true;
+                    for (int gid = 0; gid < ba.size(); ++gid) {
+                        for (int n = 0; n < ncomp; ++n) {
+                            const FArrayBox& fab = pf.getFab(0, gid, varnames[n]);
+                            ok = ok && fab.box() == ba[gid] && matches(fab, 0, n, single);
+                        }
+                        pf.clearFab(0, gid);
+                    }
+                    ParallelDescriptor::ReduceBoolAnd(ok);
+                    check(ok, what + " PlotFileData::getFab");
+
+                    ok = true;
+                    for (int n = 0; n < ncomp; ++n) {
+                        MultiFab v = pf.get(0, varnames[n]);
+                        for (MFIter mfi(v); mfi.isValid(); ++mfi) {
+                            ok = ok && matches(v[mfi], 0, n, single);
+                        }
+                    }
+                    ParallelDescriptor::ReduceBoolAnd(ok);
+                    check(ok, what + " PlotFileData::get");
+                }
+            }
+        }
+
+        VisMF::SetUseMmap(usemmap);
+    }
+    amrex::Finalize();
+}
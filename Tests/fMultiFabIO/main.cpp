@@ -0,0 +1,115 @@
+//
+// Writes an fMultiFab and a MultiFab with VisMF in each header version
+// and FAB format, and reads both back into fMultiFabs.  Reads onto the
+// same BoxArray must give the written values, ghost cells included, and
+// reads onto a different BoxArray with no ghost cells must give them in
+// the valid cells.  Aborts on any difference.
+//
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_fMultiFab.H>
+#include <AMReX_VisMF.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+namespace {
+
+long difference (const fMultiFab& a, const fMultiFab& b, int ngrow)
+{
+    long nbad = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi)
+    {
+        auto const& fa = a.const_array(mfi);
+        auto const& fb = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.growntilebox(ngrow), a.nComp(), [&] (int i, int j, int k, int n) noexcept
+        {
+            if (fa(i,j,k,n) != fb(i,j,k,n)) ++nbad;
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(nbad);
+    return nbad;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        int read_max_grid_size = 8;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("read_max_grid_size", read_max_grid_size);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        const DistributionMapping dm(ba);
+        const int ncomp = 2;
+        const int ngrow = 1;
+
+        MultiFab mf(ba, dm, ncomp, ngrow);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            auto const& a = mf.array(mfi);
+            amrex::LoopOnCpu(mfi.fabbox(), ncomp, [=] (int i, int j, int k, int n) noexcept
+            {
+                a(i,j,k,n) = std::sin(0.1*i) + 100.*j + 1.e4*k + 0.1*n;
+            });
+        }
+        fMultiFab fmf(ba, dm, ncomp, ngrow);
+        amrex::Copy(fmf, mf, 0, 0, ncomp, ngrow);
+
+        // ---- the same data, read onto other boxes without ghost cells
+        BoxArray rba(domain);
+        rba.maxSize(read_max_grid_size);
+        const DistributionMapping rdm(rba);
+        fMultiFab fexpected(rba, rdm, ncomp, 0);
+        fexpected.ParallelCopy(fmf, 0, 0, ncomp);
+
+        const FABio::Format format = FArrayBox::getFormat();
+        long nbad = 0;
+
+        for (int version : {1, 2, 3})
+        {
+            VisMF::SetHeaderVersion(VisMF::Header::Version(version));
+
+            for (FABio::Format fmt : {FABio::FAB_NATIVE, FABio::FAB_NATIVE_32, FABio::FAB_IEEE_32})
+            {
+                FArrayBox::setFormat(fmt);
+                VisMF::Write(fmf, "fMultiFabIO_f");
+                VisMF::Write(mf,  "fMultiFabIO_r");
+
+                for (const std::string name : {"fMultiFabIO_f", "fMultiFabIO_r"})
+                {
+                    fMultiFab same(ba, dm, ncomp, ngrow);
+                    VisMF::Read(same, name);
+                    const long n = difference(same, fmf, ngrow);
+
+                    fMultiFab other(rba, rdm, ncomp, 0);
+                    VisMF::Read(other, name);
+                    const long m = difference(other, fexpected, 0);
+
+                    amrex::Print() << "version " << version << " format " << int(fmt)
+                                   << " " << name << ": " << n << " and " << m
+                                   << " wrong values\n";
+                    nbad += n + m;
+                }
+            }
+        }
+
+        FArrayBox::setFormat(format);
+
+        if (nbad != 0) {
+            amrex::Abort("fMultiFabIO: data read back differ from data written");
+        }
+    }
+    amrex::Finalize();
+}
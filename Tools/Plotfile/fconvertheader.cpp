@@ -0,0 +1,53 @@
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_VisMF.H>
+
+using namespace amrex;
+
+void main_main()
+{
+    const int narg = amrex::command_argument_count();
+
+    bool binary = true;
+    int farg = 1;
+    while (farg <= narg) {
+        const std::string& name = amrex::get_command_argument(farg);
+        if (name == "-t" or name == "--text") {
+            binary = false;
+        } else {
+            break;
+        }
+        ++farg;
+    }
+
+    if (farg > narg) {
+        amrex::Print()
+            << "\n"
+            << " Usage:\n"
+            << "      fconvertheader [-t|--text] header1 [header2 ...]\n"
+            << "\n"
+            << " Description:\n"
+            << "      This program rewrites the headers of FabArrays in a plotfile or checkpoint,\n"
+            << "      e.g., plt00000/Level_0/Cell_H, in the binary format that is much faster to read\n"
+            << "      for many boxes.  With -t, binary headers are converted back to text.\n"
+            << "      The data files are not touched.\n"
+            << std::endl;
+        return;
+    }
+
+    for (; farg <= narg; ++farg) {
+        std::string mf_name = amrex::get_command_argument(farg);
+        if (mf_name.size() > 2 and mf_name.compare(mf_name.size()-2, 2, "_H") == 0) {
+            mf_name.resize(mf_name.size()-2);
+        }
+        VisMF::ConvertHeader(mf_name, binary);
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::SetVerbose(0);
+    amrex::Initialize(argc, argv, false);
+    main_main();
+    amrex::Finalize();
+}
@@ -1,7 +1,6 @@
 #include <AMReX.H>
 #include <AMReX_Print.H>
 #include <AMReX_PlotFileUtil.H>
-#include <AMReX_MultiFabUtil.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <limits>
 #include <iterator>
@@ -162,77 +161,66 @@ void main_main()
     Vector<Real> pos;
     Vector<Vector<Real> > data(var_names.size());
 
+    // Only the grids the slice passes through are read, one FAB at a time.
     IntVect rr{1};
     for (int ilev = coarse_level; ilev <= fine_level; ++ilev) {
+        const Box& probdom = pf.probDomain(ilev);
         Box slice_box(ivloc*rr,ivloc*rr);
-        slice_box.setSmall(idir, std::numeric_limits<int>::lowest());
-        slice_box.setBig(idir, std::numeric_limits<int>::max());
+        slice_box.setSmall(idir, probdom.smallEnd(idir));
+        slice_box.setBig(idir, probdom.bigEnd(idir));
 
         Array<Real,AMREX_SPACEDIM> dx = pf.cellSize(ilev);
 
+        // the next finer grids, coarsened to this level
+        BoxArray fine_ba;
+        IntVect ratio{1};
         if (ilev < fine_level) {
-            IntVect ratio{pf.refRatio(ilev)};
+            ratio = IntVect{pf.refRatio(ilev)};
             for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
                 ratio[idim] = 1;
             }
-            const iMultiFab mask = makeFineMask(pf.boxArray(ilev), pf.DistributionMap(ilev),
-                                                pf.boxArray(ilev+1), ratio);
-            for (int ivar = 0; ivar < var_names.size(); ++ivar) {
-                const MultiFab& mf = pf.get(ilev, var_names[ivar]);
-                for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-                    const Box& bx = mfi.validbox() & slice_box;
-                    if (bx.ok()) {
-                        const auto& m = mask.array(mfi);
-                        const auto& fab = mf.array(mfi);
-                        const auto lo = amrex::lbound(bx);
-                        const auto hi = amrex::ubound(bx);
-                        for         (int k = lo.z; k <= hi.z; ++k) {
-                            for     (int j = lo.y; j <= hi.y; ++j) {
-                                for (int i = lo.x; i <= hi.x; ++i) {
-                                    if (m(i,j,k) == 0) { // not covered by fine
-                                        if (pos.size() == data[ivar].size()) {
-                                            Array<Real,AMREX_SPACEDIM> p
-                                                = {AMREX_D_DECL(problo[0]+(i+0.5)*dx[0],
-                                                                problo[1]+(j+0.5)*dx[1],
-                                                                problo[2]+(k+0.5)*dx[2])};
-                                            pos.push_back(p[idir]);
-                                        }
-                                        data[ivar].push_back(fab(i,j,k));
-                                    }
-                                }
-                            }
-                        }
-                    }
+            fine_ba = amrex::coarsen(pf.boxArray(ilev+1), ratio);
+        }
+
+        const DistributionMapping& dm = pf.DistributionMap(ilev);
+        for (auto const& isect : pf.boxArray(ilev).intersections(slice_box)) {
+            const int gid = isect.first;
+            if (dm[gid] != ParallelDescriptor::MyProc()) continue;
+
+            const Box& bx = isect.second;
+            BaseFab<int> mask(bx);
+            mask.setVal(0);
+            if (ilev < fine_level) {
+                for (auto const& fisect : fine_ba.intersections(bx)) {
+                    mask.setVal(1, fisect.second);
                 }
             }
-            rr *= ratio;
-        } else {
+            const auto& m = mask.const_array();
+            const auto lo = amrex::lbound(bx);
+            const auto hi = amrex::ubound(bx);
+
             for (int ivar = 0; ivar < var_names.size(); ++ivar) {
-                const MultiFab& mf = pf.get(ilev, var_names[ivar]);
-                for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
-                    const Box& bx = mfi.validbox() & slice_box;
-                    if (bx.ok()) {
-                        const auto& fab = mf.array(mfi);
-                        const auto lo = amrex::lbound(bx);
-                        const auto hi = amrex::ubound(bx);
-                        for         (int k = lo.z; k <= hi.z; ++k) {
-                            for     (int j = lo.y; j <= hi.y; ++j) {
-                                for (int i = lo.x; i <= hi.x; ++i) {
-                                    if (pos.size() == data[ivar].size()) {
-                                        Array<Real,AMREX_SPACEDIM> p
-                                            = {AMREX_D_DECL(problo[0]+(i+0.5)*dx[0],
-                                                            problo[1]+(j+0.5)*dx[1],
-                                                            problo[2]+(k+0.5)*dx[2])};
-                                        pos.push_back(p[idir]);
-                                    }
-                                    data[ivar].push_back(fab(i,j,k));
+                const auto& fab = pf.getFab(ilev, gid, var_names[ivar]).const_array();
+                for         (int k = lo.z; k <= hi.z; ++k) {
+                    for     (int j = lo.y; j <= hi.y; ++j) {
+                        for (int i = lo.x; i <= hi.x; ++i) {
+                            if (m(i,j,k) == 0) { // not covered by fine
+                                if (pos.size() == data[ivar].size()) {
+                                    Array<Real,AMREX_SPACEDIM> p
+                                        = {AMREX_D_DECL(problo[0]+(i+0.5)*dx[0],
+                                                        problo[1]+(j+0.5)*dx[1],
+                                                        problo[2]+(k+0.5)*dx[2])};
+                                    pos.push_back(p[idir]);
                                 }
+                                data[ivar].push_back(fab(i,j,k));
                             }
                         }
                     }
                 }
             }
+            pf.clearFab(ilev, gid);
         }
+        rr *= ratio;
     }
 
 #ifdef BL_USE_MPI
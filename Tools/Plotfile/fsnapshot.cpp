@@ -29,6 +29,7 @@ void main_main()
                               std::numeric_limits<Real>::lowest()};
     std::string compname = "density";
     int max_level = -1;
+    int coarsen = 1;
     bool ldef_mx = false;
     bool ldef_mn = false;
     bool do_log = false;
@@ -52,6 +53,8 @@ void main_main()
             ldef_mn = true;
         } else if (name == "-L" or name == "--max_level") {
             max_level = std::stoi(amrex::get_command_argument(++farg));
+        } else if (name == "-r" or name == "--coarsen") {
+            coarsen = std::stoi(amrex::get_command_argument(++farg));
         } else if (name == "-l" or name == "--log") {
             do_log = true;
         } else if (name == "-g" or name == "--origin") {
@@ -81,6 +84,8 @@ void main_main()
             << "      -m val                     : set the minimum value of the data to val\n"
             << "      -M val                     : set the maximum value of the data to val\n"
             << "      [-L|--max_level] n         : max fine level to get data from (default: finest)\n"
+            << "      [-r|--coarsen] r           : image coarsened by r, e.g., 2, 4 or 8, for a quick preview.  If the\n"
+            << "                                   plotfile has a preview pyramid, the full data are not read.\n"
             << "      [-l|--log]                 : toggle log plot\n"
             << "      [-n|--normaldir] {0,1,2,3} : direction normal to slice. (default: 3, i.e., all directions)\n"
             << "                                   This option is for 3d plotfile only.\n"
@@ -96,6 +101,7 @@ void main_main()
     }
 
     // make sure we have valid options set
+    if (coarsen < 1) amrex::Abort("ERROR: coarsening ratio must be positive");
     if (do_log) {
         if (ldef_mx and def_mx < 0.) amrex::Abort("ERROR: log plot specified with negative maximum");
         if (ldef_mn and def_mn < 0.) amrex::Abort("ERROR: log plot specified with negative minimum");
@@ -138,7 +144,12 @@ void main_main()
         amrex::Abort("ERROR: " + compname + " not found in pltfile " + pltfile);
     }
 
-    const Box& finedomainbox = pf.probDomain(max_level);
+    IntVect crr(coarsen);
+    for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
+        crr[idim] = 1;
+    }
+
+    const Box& finedomainbox = amrex::coarsen(pf.probDomain(max_level), crr);
     const auto flo = amrex::lbound(finedomainbox);
     const auto fhi = amrex::ubound(finedomainbox);
     int iloc[3];
@@ -156,7 +167,7 @@ void main_main()
         Array<Real,AMREX_SPACEDIM> problo = pf.probLo();
         Array<Real,AMREX_SPACEDIM> dx = pf.cellSize(max_level);
         for (int idim = 0; idim < dim; ++idim) {
-            iloc[idim] = (location[idim]-problo[idim]) / dx[idim];
+            iloc[idim] = (location[idim]-problo[idim]) / (dx[idim]*coarsen);
         }
     }
 
@@ -197,15 +208,21 @@ void main_main()
     Real gmn = std::numeric_limits<Real>::max();
 
     for (int ilev = 0; ilev <= max_level; ++ilev) {
-        const MultiFab& pltmf = pf.get(ilev, compname);
-        gmx = std::max(gmx, pltmf.max(0));
-        gmn = std::min(gmn, pltmf.min(0));
+        const MultiFab& pltmf = pf.getCoarsened(ilev, compname, coarsen);
+        if (coarsen == 1) {
+            gmx = std::max(gmx, pltmf.max(0));
+            gmn = std::min(gmn, pltmf.min(0));
+        } else {
+            // the range of the full data, not of the averages
+            gmx = std::max(gmx, pf.max(ilev, compname));
+            gmn = std::min(gmn, pf.min(ilev, compname));
+        }
         if (ilev < max_level) {
             IntVect ratio{pf.refRatio(ilev)};
             for (int idim = dim; idim < AMREX_SPACEDIM; ++idim) {
                 ratio[idim] = 1;
             }
-            const iMultiFab mask = makeFineMask(pltmf, pf.boxArray(ilev+1), ratio);
+            const iMultiFab mask = makeFineMask(pltmf, amrex::coarsen(pf.boxArray(ilev+1), crr), ratio);
             for (MFIter mfi(pltmf); mfi.isValid(); ++mfi) {
                 const auto& m = mask.array(mfi);
                 const auto& plt = pltmf.array(mfi);
@@ -76,7 +76,12 @@ AmrLevelAdv::checkPoint (const std::string& dir,
   AmrLevel::checkPoint(dir, os, how, dump_old);
 #ifdef AMREX_PARTICLES
   if (do_tracers and level == 0) {
-    TracerPC->Checkpoint(dir, "Tracer", true);
+    // With amr.checkpoint_async, the particles are written in the background too.
+    if (auto writes = parent->asyncCheckPointWrites()) {
+      writes->push_back(TracerPC->CheckpointAsync(dir, "Tracer"));
+    } else {
+      TracerPC->Checkpoint(dir, "Tracer", true);
+    }
   }
 #endif
 }